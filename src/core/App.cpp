@@ -1,9 +1,13 @@
 #include "core/App.hpp"
 #include "core/LTimer.hpp"
+#include "core/HiResClock.hpp"
+#include "core/FramePacer.hpp"
+#include "core/FrameExporter.hpp"
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
 #include <cstdio>
+#include <algorithm>
 
 bool App::init() {
     // Đọc cấu hình từ file JSON
@@ -11,28 +15,47 @@ bool App::init() {
         SDL_Log("Failed to load config files.\n");
         return false;
     }
+    // Ghi hình trên server không màn hình: dùng driver giả cho video & audio
+    if (config.recordEnabled && config.recordHeadless) {
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+    }
     // Khởi tạo SDL (Video & Audio)
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
         SDL_Log("SDL_Init Error: %s\n", SDL_GetError());
         return false;
     }
-    // Tạo cửa sổ game
-    window = SDL_CreateWindow("Tiny Football Arena",
-                              SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                              config.windowWidth, config.windowHeight, 0);
-    if (!window) {
-        SDL_Log("Create Window Error: %s\n", SDL_GetError());
-        return false;
-    }
-    // Tạo renderer với hoặc không VSYNC tùy theo config
-    Uint32 render_flags = SDL_RENDERER_ACCELERATED;
-    if (config.vsync) {
-        render_flags |= SDL_RENDERER_PRESENTVSYNC;
-    }
-    renderer = SDL_CreateRenderer(window, -1, render_flags);
-    if (!renderer) {
-        SDL_Log("Create Renderer Error: %s\n", SDL_GetError());
-        return false;
+    if (config.recordEnabled) {
+        // Ghi hình: renderer phần mềm vẽ thẳng vào surface RGBA, không cần cửa sổ
+        offscreen = SDL_CreateRGBSurfaceWithFormat(0, config.windowWidth, config.windowHeight, 32, SDL_PIXELFORMAT_RGBA32);
+        if (!offscreen) {
+            SDL_Log("Create Surface Error: %s\n", SDL_GetError());
+            return false;
+        }
+        renderer = SDL_CreateSoftwareRenderer(offscreen);
+        if (!renderer) {
+            SDL_Log("Create Software Renderer Error: %s\n", SDL_GetError());
+            return false;
+        }
+    } else {
+        // Tạo cửa sổ game
+        window = SDL_CreateWindow("Tiny Football Arena",
+                                  SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                  config.windowWidth, config.windowHeight, 0);
+        if (!window) {
+            SDL_Log("Create Window Error: %s\n", SDL_GetError());
+            return false;
+        }
+        // Tạo renderer với hoặc không VSYNC tùy theo config
+        Uint32 render_flags = SDL_RENDERER_ACCELERATED;
+        if (config.vsync) {
+            render_flags |= SDL_RENDERER_PRESENTVSYNC;
+        }
+        renderer = SDL_CreateRenderer(window, -1, render_flags);
+        if (!renderer) {
+            SDL_Log("Create Renderer Error: %s\n", SDL_GetError());
+            return false;
+        }
     }
     // Khởi tạo SDL_image (hỗ trợ PNG)
     if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
@@ -62,6 +85,8 @@ bool App::init() {
 }
 
 void App::run() {
+    if (config.recordEnabled) { runOffscreen(); return; }
+
     bool quit = false;
     SDL_Event e;
     // Đối tượng Timer tính toán delta time mỗi frame
@@ -69,12 +94,34 @@ void App::run() {
     frameTimer.setVSync(config.vsync);
     frameTimer.start();
 
+    // Điều nhịp frame: giới hạn FPS / low-latency (ngủ tới sát vsync rồi mới lấy mẫu input) / tiết kiệm điện
+    FramePacer pacer;
+    {
+        FramePacer::Params pp;
+        SDL_DisplayMode mode{};
+        pp.vsync      = config.vsync;
+        pp.refreshHz  = (SDL_GetWindowDisplayMode(window, &mode) == 0 && mode.refresh_rate > 0) ? mode.refresh_rate : 60;
+        pp.targetFps  = std::max(0.f, config.targetFps);
+        pp.idleFps    = std::max(0.f, config.idleFps);
+        pp.lowLatency = config.lowLatency;
+        pp.marginMs   = std::max(0.f, config.lowLatencyMarginMs);
+        pp.spinMs     = std::max(0.f, config.spinMs);
+        pp.smoothDt   = config.smoothDt;
+        pacer.init(pp);
+    }
+
     // Vòng lặp chính
     while (!quit) {
+        pacer.waitForFrame(game.isIdle());
+
         // Xử lý sự kiện hệ thống (đóng cửa sổ, phím bấm,...)
         while (SDL_PollEvent(&e)) {
             if (e.type == SDL_QUIT) {
                 quit = true;
+            } else if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET ||
+                       (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)) {
+                // Nội dung render target bị mất hoặc kích thước đổi -> dựng lại nền cache
+                game.invalidateStaticLayers();
             } else {
                 input.handleEvent(e);
             }
@@ -85,18 +132,73 @@ void App::run() {
             game.togglePause();
             input.pausePressed = false;
         }
+        // Checkpoint ô nhanh (giữa 2 tick nên không cắt ngang bước mô phỏng)
+        if (input.savePressed) { game.quickSave(); input.savePressed = false; }
+        if (input.loadPressed) { game.quickLoad(); input.loadPressed = false; }
         // Cập nhật trạng thái input liên tục (phím mũi tên, WASD)
         input.update();
-        // Tính thời gian frame
-        float dt = frameTimer.getDeltaSeconds();
+        // Tính thời gian frame (đã làm mượt)
+        float dt = pacer.smooth(frameTimer.getDeltaSeconds());
         // Cập nhật game logic (nếu không pause)
         game.update(dt);
         // Vẽ khung hình
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_RenderClear(renderer);
         game.render(renderer);
+        Uint64 submitted = HiResClock::now();
+        SDL_RenderPresent(renderer);
+        Uint64 presented = HiResClock::now();
+
+        pacer.onPresented(submitted, presented);
+
+        if (config.latencyStats) {
+            latency.onFrame(input.sampledKeys(), input.sampledKeyCount(), input.sampleTime(), presented);
+            latency.maybeReport(presented, config.latencyReportSec);
+        }
+    }
+    if (config.latencyStats) latency.report(pacer.lateSampling() ? "Latency (session, low-latency)" : "Latency (session)");
+}
+
+void App::runOffscreen() {
+    FrameExporter exporter;
+    FrameExporter::Format fmt = (config.recordFormat == "rgb") ? FrameExporter::Format::RawRgb
+                                                               : FrameExporter::Format::Png;
+    if (!exporter.start(fmt, config.recordOut, offscreen->w, offscreen->h, config.recordThreads)) return;
+
+    // Bước thời gian cố định theo fps ghi hình (không phụ thuộc tốc độ máy)
+    const int   fps = std::max(1, config.recordFps);
+    const float dt  = 1.0f / (float)fps;
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter(), lastReport = start;
+    int frames = 0, framesAtReport = 0;
+
+    SDL_Event e;
+    while (!game.isFinished() && (config.recordMaxFrames <= 0 || frames < config.recordMaxFrames)) {
+        bool quit = false;
+        while (SDL_PollEvent(&e)) if (e.type == SDL_QUIT) quit = true;
+        if (quit) break;
+
+        input.update();
+        game.update(dt);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        game.render(renderer);
         SDL_RenderPresent(renderer);
+        exporter.submit(offscreen->pixels, offscreen->pitch);
+        ++frames;
+
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now - lastReport >= freq) {
+            double sec = (double)(now - lastReport) / (double)freq;
+            SDL_Log("Record: %d frames, %.1f frames/s (encoded %d)\n",
+                    frames, (frames - framesAtReport) / sec, exporter.encodedFrames());
+            lastReport = now; framesAtReport = frames;
+        }
     }
+
+    double total = (double)(SDL_GetPerformanceCounter() - start) / (double)freq;
+    SDL_Log("Record: rendered %d frames in %.2fs (%.1f frames/s)\n", frames, total, total > 0 ? frames / total : 0.0);
+    exporter.finish();
 }
 
 void App::cleanup() {
@@ -112,6 +214,7 @@ void App::cleanup() {
     IMG_Quit();
     // Hủy renderer và window
     if (renderer) SDL_DestroyRenderer(renderer);
+    if (offscreen) SDL_FreeSurface(offscreen);
     if (window) SDL_DestroyWindow(window);
     SDL_Quit();
 }
@@ -3,6 +3,7 @@
 #include "core/Config.hpp"
 #include "core/Input.hpp"
 #include "core/Game.hpp"
+#include "core/LatencyMonitor.hpp"
 
 // Lớp App quản lý khởi tạo SDL, cửa sổ, renderer, vòng lặp chính
 class App {
@@ -15,9 +16,14 @@ public:
     void cleanup();
 
 private:
+    // Vòng lặp ghi hình: bước thời gian cố định, render phần mềm vào offscreen, xuất frame
+    void runOffscreen();
+
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
+    SDL_Surface* offscreen = nullptr;   // đích render khi ghi hình (không có cửa sổ)
     Config config;         // cấu hình game đọc từ JSON
     InputSystem input;     // hệ thống xử lý input
     Game game;             // đối tượng game (quản lý scene, trạng thái)
+    LatencyMonitor latency; // đo độ trễ phím -> present
 };
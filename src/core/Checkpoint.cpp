@@ -0,0 +1,84 @@
+#include "core/Checkpoint.hpp"
+#include <cstdio>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace Checkpoint {
+
+bool save(const std::string& path, const Image& img) {
+    std::string tmp = path + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&img, sizeof(Image), 1, f) == 1;
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) { std::remove(tmp.c_str()); return false; }
+#ifdef _WIN32
+    ok = MoveFileExA(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) std::remove(tmp.c_str());
+    return ok;
+}
+
+bool Mapping::open(const std::string& path) {
+    close();
+    const void* base = nullptr;
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz; GetFileSizeEx(f, &sz);
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m) { CloseHandle(f); return false; }
+    fileHandle = f; mapHandle = m;
+    size = (size_t)sz.QuadPart;
+    base = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Image)) { close(); return false; }
+    size = (size_t)st.st_size;
+    int flags = MAP_PRIVATE;
+  #ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;   // vài trang: nạp sẵn luôn, lần đọc đầu không bị page fault
+  #endif
+    void* p = mmap(nullptr, size, PROT_READ, flags, fd, 0);
+    if (p != MAP_FAILED) base = p;
+#endif
+    // vùng map căn theo trang nên ép kiểu thẳng sang Image là hợp lệ
+    img = static_cast<const Image*>(base);
+    if (!img || size < sizeof(Image) || !valid(img->header)) { close(); return false; }
+    return true;
+}
+
+void Mapping::close() {
+#ifdef _WIN32
+    if (img) UnmapViewOfFile(img);
+    if (mapHandle) CloseHandle((HANDLE)mapHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+    mapHandle = fileHandle = nullptr;
+#else
+    if (img) munmap(const_cast<Image*>(img), size);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    img = nullptr;
+    size = 0;
+}
+
+} // namespace Checkpoint
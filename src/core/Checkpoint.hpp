@@ -0,0 +1,137 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include "util/Math.hpp"
+
+// ===== Checkpoint (.tfac): ảnh chụp toàn bộ trạng thái mô phỏng giữa trận =====
+// Một khối POD kích thước cố định, không chứa con trỏ (chủ bóng lưu bằng id) nên file chính là ảnh
+// bộ nhớ: nạp = mmap + kiểm tra header + gán lại con trỏ chủ bóng, không phân tích gì.
+// Trong RAM, Image cũng là điểm rẽ nhánh: nạp cùng một Image vào nhiều scene để chạy hàng nghìn
+// mô phỏng từ cùng một khoảnh khắc.
+namespace Checkpoint {
+
+const uint32_t MAGIC   = 0x43414654u;   // "TFAC"
+const uint32_t VERSION = 1;
+
+const int PLAYER_COUNT = 4;     // p1, p2, gk1, gk2 (id 1..4)
+const int MAX_BODIES   = 8;     // trạng thái ngủ theo id thực thể
+const int MAX_CONTACTS = 32;    // cache xung warm start
+const int RNG_STREAMS  = 4;     // MatchRng::StreamCount
+const int NOISE_CELLS  = 256;   // nhiễu WindField 16x16
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t imageSize;       // sizeof(Image) lúc ghi: khác = layout khác
+    uint32_t fixedPoint;      // chụp bằng build TFA_FIXED_POINT?
+    uint64_t configHash;      // băm config lúc chụp
+    uint64_t seed;
+    uint64_t stateHash;       // MatchScene::stateHash() lúc chụp: nạp xong băm lại phải trùng
+};
+
+struct BallState {
+    Vec2    pos, vel;
+    float   drag, justKicked;
+    int32_t ownerId;          // -1 = bóng tự do (thay cho con trỏ Ball::owner)
+    int32_t lastKickerId;
+};
+
+struct PlayerState {
+    Vec2    pos, vel, facing;
+    float   drag;
+    float   shootCooldown, slideCooldown, tackleTimer;
+    float   dribbleClock;
+    Vec2    dribbleAim;
+    uint8_t controlled, tackling, dir, pad;
+};
+
+struct KeeperState { int32_t st; float stTime, hold; };
+
+struct BodyState    { float idle; Vec2 restPos; uint8_t asleep, pad[3]; };
+struct ContactState { uint32_t key; Vec2 n; float jn; int32_t jvRaw; };
+
+struct PhysicsState {
+    int32_t      bodyCount, contactCount;
+    BodyState    bodies[MAX_BODIES];
+    ContactState contacts[MAX_CONTACTS];
+};
+
+struct WindState {
+    Vec2 drift;
+    Vec2 noise[NOISE_CELLS];
+};
+
+struct StatsState {
+    struct Side { float possession; int32_t shots, onTarget, saves, tackles; float distance; } sides[2];
+    int32_t live, ctrlSide, pendingShot;
+    float   ctrlSince;
+};
+
+struct Image {
+    Header header;
+
+    // Trận: trạng thái, hiệp, đồng hồ, tỉ số
+    uint32_t tick;
+    float    simTime;
+    int32_t  state, half;
+    float    timeRemaining, stateTimer;
+    float    pickupCooldown, gk1Hold, gk2Hold;
+    int32_t  scoreLeft, scoreRight;
+
+    // Gió
+    uint8_t  extForces, weatherMode, key2Prev, key3Prev;
+    Vec2     wind;
+    float    gustTimer, windDirTimer;
+
+    BallState    ball;
+    PlayerState  players[PLAYER_COUNT];
+    KeeperState  keepers[2];
+
+    uint64_t     rngSeed;
+    uint64_t     rngState[RNG_STREAMS];
+    uint64_t     rngInc[RNG_STREAMS];
+
+    PhysicsState physics;
+    WindState    windField;
+    StatsState   stats;
+};
+
+static_assert(sizeof(Header) == 40, "Checkpoint::Header phải cố định 40 byte");
+static_assert(sizeof(Image) == 3352, "Checkpoint::Image đổi layout: tăng VERSION");
+static_assert(std::is_trivially_copyable<Image>::value, "Checkpoint::Image phải copy được bằng memcpy");
+
+// Header hợp lệ với build hiện tại?
+inline bool valid(const Header& h) {
+    return h.magic == MAGIC && h.version == VERSION && h.imageSize == sizeof(Image);
+}
+
+// Ghi cả khối bằng 1 lần fwrite (qua file tạm rồi đổi tên: không bao giờ để lại file ghi dở)
+bool save(const std::string& path, const Image& img);
+
+// Ánh xạ file checkpoint chỉ đọc; image() trỏ thẳng vào vùng map (giữ Mapping để rẽ nhánh nhiều lần)
+class Mapping {
+public:
+    Mapping() = default;
+    ~Mapping() { close(); }
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return img != nullptr; }
+    const Image& image() const { return *img; }
+
+private:
+    const Image* img = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mapHandle  = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+} // namespace Checkpoint
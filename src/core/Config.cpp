@@ -15,13 +15,21 @@ static std::string trim(const std::string& s) {
 // (Lưu ý: Hàm này được dùng trong InputSystem; không sử dụng trực tiếp ở đây)
 static inline int mapKeyName(const std::string& name);
 
+// FNV-1a 64-bit, cộng dồn từng dòng
+static uint64_t fnv1a(uint64_t h, const std::string& s) {
+    for (unsigned char c : s) { h ^= c; h *= 1099511628211ULL; }
+    return h;
+}
+
 // Hàm load config từ file JSON
 bool Config::loadFromFile(const std::string& gameConfigFile, const std::string& inputConfigFile) {
     std::ifstream fin(gameConfigFile);
     if (!fin.is_open()) return false;
     std::string line;
     std::string section;
+    configHash = 14695981039346656037ULL;
     while (std::getline(fin, line)) {
+        configHash = fnv1a(configHash, line);
         line = trim(line);
         if (line.empty()) continue;
         if (line.back() == '{') {
@@ -59,6 +67,15 @@ bool Config::loadFromFile(const std::string& gameConfigFile, const std::string&
             if (key == "w") windowWidth = std::stoi(value);
             else if (key == "h") windowHeight = std::stoi(value);
             else if (key == "vsync") vsync = (value == "true");
+        } else if (section == "timing") {
+            if (key == "target_fps") targetFps = std::stof(value);
+            else if (key == "idle_fps") idleFps = std::stof(value);
+            else if (key == "spin_ms") spinMs = std::stof(value);
+            else if (key == "smooth_dt") smoothDt = (value == "true");
+            else if (key == "low_latency") lowLatency = (value == "true");
+            else if (key == "low_latency_margin_ms") lowLatencyMarginMs = std::stof(value);
+            else if (key == "latency_stats") latencyStats = (value == "true");
+            else if (key == "latency_report_sec") latencyReportSec = std::stof(value);
         } else if (section == "world") {
             if (key == "meters_per_px") {
                 meters_per_px = std::stof(value);
@@ -78,9 +95,34 @@ bool Config::loadFromFile(const std::string& gameConfigFile, const std::string&
                     fieldHeight = static_cast<int>(pitchHm / meters_per_px + 0.5f);
                 }
             }
+        } else if (section == "physics") {
+            if (key == "substeps") physicsSubsteps = std::max(1, std::stoi(value));
+            else if (key == "iterations") physicsIterations = std::max(1, std::stoi(value));
+            else if (key == "warm_start") physicsWarmStart = (value == "true");
+            else if (key == "baumgarte") physicsBaumgarte = std::stof(value);
+            else if (key == "slop") physicsSlop = std::stof(value);
+            else if (key == "sleep") physicsSleep = (value == "true");
+            else if (key == "sleep_speed") physicsSleepSpeed = std::stof(value);
+            else if (key == "sleep_time") physicsSleepTime = std::stof(value);
         } else if (section == "camera") {
             if (key == "deadzone_ratio") cameraDeadzoneRatio = std::stof(value);
             else if (key == "lerp") cameraLerp = std::stof(value);
+        } else if (section == "pitch") {
+            if (!value.empty() && value.front() == '"') value = value.substr(1, value.find_last_of('"') - 1);
+            if (key == "image") pitchImage = value;
+            else if (key == "tile_px") {
+                pitchTilePx = std::max(16, std::stoi(value));
+                while (pitchTilePx & (pitchTilePx - 1)) pitchTilePx &= pitchTilePx - 1;   // làm tròn xuống lũy thừa của 2
+            }
+            else if (key == "budget_mb") pitchBudgetMb = std::max(1, std::stoi(value));
+            else if (key == "uploads_per_frame") pitchUploadsPerFrame = std::max(1, std::stoi(value));
+        } else if (section == "particles") {
+            if (key == "capacity") particleCapacity = std::max(0, std::stoi(value));
+            else if (key == "trail_speed") particleTrailSpeed = std::stof(value);
+            else if (key == "goal_confetti") particleGoalConfetti = std::max(0, std::stoi(value));
+        } else if (section == "audio") {
+            if (key == "voices") audioVoices = std::max(1, std::stoi(value));
+            else if (key == "wall_hits_per_100ms") audioWallPer100ms = std::max(1, std::stoi(value));
         } else if (section == "ball") {
             if (key == "r_m") {
                 float r_m = std::stof(value);
@@ -119,11 +161,42 @@ bool Config::loadFromFile(const std::string& gameConfigFile, const std::string&
             else if (key == "cooldown") tackleCooldown = std::stof(value);
             else if (key == "intercept_slack_m") tackleInterceptSlack = std::stof(value) / meters_per_px;
             else if (key == "dislodge_speed") tackleDislodgeSpeed = std::stof(value) * pixel_per_meter;
+        } else if (section == "telemetry") {
+            if (!value.empty() && value.front() == '"') value = value.substr(1, value.find_last_of('"') - 1);
+            if (key == "enabled") telemetryEnabled = (value == "true");
+            else if (key == "dir") telemetryDir = value;
+            else if (key == "index_interval") telemetryIndexInterval = std::stoi(value);
+            else if (key == "compress") telemetryCompress = (value == "true");
+            else if (key == "pos_precision") telemetryPosPrecision = std::stof(value);
+            else if (key == "vel_precision") telemetryVelPrecision = std::stof(value);
+        } else if (section == "replay") {
+            if (!value.empty() && value.front() == '"') value = value.substr(1, value.find_last_of('"') - 1);
+            if (key == "record") replayRecord = (value == "true");
+            else if (key == "dir") replayDir = value;
+            else if (key == "play") replayPlay = value;
+        } else if (section == "checkpoint") {
+            if (!value.empty() && value.front() == '"') value = value.substr(1, value.find_last_of('"') - 1);
+            if (key == "dir") checkpointDir = value;
+            else if (key == "load") checkpointLoad = value;
+        } else if (section == "record") {
+            if (!value.empty() && value.front() == '"') value = value.substr(1, value.find_last_of('"') - 1);
+            if (key == "enabled") recordEnabled = (value == "true");
+            else if (key == "headless") recordHeadless = (value == "true");
+            else if (key == "out") recordOut = value;
+            else if (key == "format") recordFormat = value;
+            else if (key == "fps") recordFps = std::stoi(value);
+            else if (key == "frames") recordMaxFrames = std::stoi(value);
+            else if (key == "threads") recordThreads = std::stoi(value);
         } else if (section == "match") {
             if (key == "halves") matchHalves = std::stoi(value);
             else if (key == "half_seconds") halfTimeSeconds = std::stoi(value);
             else if (key == "goal_freeze") goalFreezeTime = std::stof(value);
             else if (key == "kickoff_lock") kickoffLockTime = std::stof(value);
+            else if (key == "seed") matchSeed = std::stoull(value);
+            else if (key == "results_file") {
+                if (!value.empty() && value.front() == '"') value = value.substr(1, value.find_last_of('"') - 1);
+                resultsFile = value;
+            }
         }
     }
     fin.close();
@@ -133,6 +206,7 @@ bool Config::loadFromFile(const std::string& gameConfigFile, const std::string&
     if (!fin2.is_open()) return false;
     section.clear();
     while (std::getline(fin2, line)) {
+        configHash = fnv1a(configHash, line);
         line = trim(line);
         if (line.empty()) continue;
         if (line.back() == '{') {
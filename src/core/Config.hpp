@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <cstdint>
 
 // Cấu trúc cấu hình game, chứa các tham số đọc từ file JSON
 struct Config {
@@ -8,6 +9,16 @@ struct Config {
     int windowHeight = 720;
     bool vsync = true;
 
+    // Thời gian / độ trễ / điều nhịp frame
+    float targetFps = 0.f;             // 0 = không giới hạn (vsync tự điều nhịp nếu bật)
+    float idleFps = 20.f;              // FPS khi dừng bóng / nghỉ giữa hiệp / pause (0 = tắt)
+    float spinMs = 1.5f;               // phần cuối của mỗi lần chờ dùng quay vòng thay vì ngủ
+    bool smoothDt = true;              // làm mượt dt đưa vào mô phỏng
+    bool lowLatency = false;           // lấy mẫu input muộn nhất có thể trước vsync kế tiếp
+    float lowLatencyMarginMs = 1.0f;   // chừa thêm trước vsync (ms)
+    bool latencyStats = false;         // đo phím -> present
+    float latencyReportSec = 5.0f;     // chu kỳ log (0 = chỉ tổng kết khi thoát)
+
     // Tỉ lệ đơn vị thế giới
     float meters_per_px = 0.025f;
     float pixel_per_meter = 40.0f;
@@ -16,10 +27,35 @@ struct Config {
     int fieldWidth = 1280;
     int fieldHeight = 720;
 
+    // Bộ giải va chạm (sequential impulses)
+    int physicsSubsteps = 2;           // bước con mỗi tick
+    int physicsIterations = 6;         // vòng giải mỗi bước con
+    bool physicsWarmStart = true;      // dùng lại xung của tick trước
+    float physicsBaumgarte = 0.3f;     // tỉ lệ sửa xuyên mỗi vòng
+    float physicsSlop = 0.5f;          // px xuyên cho phép
+    bool physicsSleep = true;          // cho nhóm vật đứng yên "ngủ" (bỏ qua mô phỏng)
+    float physicsSleepSpeed = 4.0f;    // px/s
+    float physicsSleepTime = 0.5f;     // s
+
     // Camera
     float cameraDeadzoneRatio = 0.3f;
     float cameraLerp = 0.1f;
 
+    // Ảnh sân chia tile (nạp theo vùng camera)
+    std::string pitchImage = "assets/images/pitch2.png";
+    int pitchTilePx = 512;             // cạnh tile, lũy thừa của 2 (bị kẹp theo max texture size của renderer)
+    int pitchBudgetMb = 32;            // ngân sách texture cho tile sân
+    int pitchUploadsPerFrame = 4;      // số tile tối đa upload mỗi frame
+
+    // Hiệu ứng hạt
+    int particleCapacity = 65536;      // dung lượng pool (0 = tắt)
+    float particleTrailSpeed = 480.0f; // bóng nhanh hơn (px/s) mới có vệt
+    int particleGoalConfetti = 1500;   // số hạt pháo giấy mỗi bàn thắng
+
+    // Âm thanh
+    int audioVoices = 16;              // số kênh SFX cố định
+    int audioWallPer100ms = 3;         // tối đa tiếng chạm tường mỗi 100 ms
+
     // Bóng
     float ballRadius = 0.0f;    // px
     float ballMass = 0.0f;
@@ -60,6 +96,34 @@ struct Config {
     int halfTimeSeconds = 120;
     float goalFreezeTime = 2.0f;
     float kickoffLockTime = 1.0f;
+    uint64_t matchSeed = 0;        // 0 = lấy seed theo thời gian (mỗi trận khác nhau)
+    std::string resultsFile;       // file ghi kết quả trận (JSON lines); rỗng = chỉ log
+
+    // Telemetry nhị phân mỗi tick (phân tích offline)
+    bool telemetryEnabled = false;
+    std::string telemetryDir = "telemetry";   // file: <dir>/match_<seed>.tfat
+    int telemetryIndexInterval = 256;          // số tick giữa 2 index
+    bool telemetryCompress = false;            // true = ghi .tfaq nén (lượng tử + delta)
+    float telemetryPosPrecision = 0.125f;      // bước lượng tử vị trí (px)
+    float telemetryVelPrecision = 0.5f;        // bước lượng tử vận tốc (px/s)
+
+    // Replay: log input mỗi tick + băm trạng thái, chạy lại thì đối chiếu băm từng tick
+    bool replayRecord = false;
+    std::string replayDir = "replays";   // file: <dir>/match_<seed>.tfar
+    std::string replayPlay;              // đường dẫn .tfar để chạy lại (rỗng = chơi bình thường)
+
+    // Checkpoint: F5 lưu / F9 nạp ô nhanh <dir>/quick.tfac; load = tiếp tục trận từ file lúc khởi động
+    std::string checkpointDir = "checkpoints";
+    std::string checkpointLoad;          // rỗng = bắt đầu từ kickoff
+
+    // Ghi hình offscreen (render server không có màn hình)
+    bool recordEnabled = false;
+    bool recordHeadless = true;          // dùng video/audio driver "dummy"
+    std::string recordOut = "record";    // thư mục PNG, hoặc file/pipe RGB ("-" = stdout)
+    std::string recordFormat = "png";    // "png" | "rgb"
+    int recordFps = 60;
+    int recordMaxFrames = 0;             // 0 = tới hết trận
+    int recordThreads = 4;               // số luồng encoder
 
     // Phím điều khiển
     struct KeyMap {
@@ -67,5 +131,8 @@ struct Config {
         std::string switchGK; // <<< THÊM DÒNG NÀY
     } keysP1, keysP2;
 
+    // Băm FNV-1a nội dung 2 file config (ghi vào telemetry/replay để đối chiếu)
+    uint64_t configHash = 0;
+
     bool loadFromFile(const std::string& gameConfigFile, const std::string& inputConfigFile);
 };
@@ -0,0 +1,132 @@
+#include "core/FrameExporter.hpp"
+#include <SDL_image.h>
+#include <cstring>
+#include <filesystem>
+
+bool FrameExporter::start(Format fmt, const std::string& out, int width, int height, int threads) {
+    finish();
+    format = fmt; outPath = out; w = width; h = height;
+
+    if (format == Format::Png) {
+        std::error_code ec;
+        std::filesystem::create_directories(outPath, ec);
+        if (ec) { SDL_Log("FrameExporter: cannot create %s\n", outPath.c_str()); return false; }
+    } else {
+        rawOut = (outPath == "-") ? stdout : std::fopen(outPath.c_str(), "wb");
+        if (!rawOut) { SDL_Log("FrameExporter: cannot open %s\n", outPath.c_str()); return false; }
+    }
+
+    threads = threads < 1 ? 1 : threads;
+    // 2 slot mỗi luồng: render ghi slot mới trong lúc encoder đang nén slot cũ
+    slots.assign((size_t)threads * 2, Slot{});
+    freeSlots.clear();
+    for (int i = 0; i < (int)slots.size(); ++i) {
+        slots[i].rgba.resize((size_t)w * h * 4);
+        if (format == Format::RawRgb) slots[i].rgb.resize((size_t)w * h * 3);
+        freeSlots.push_back(i);
+    }
+
+    stopping = false; running = true;
+    submitted = 0; encoded = 0; nextToWrite = 0; stallSec = 0.0;
+    startCounter = SDL_GetPerformanceCounter();
+    for (int i = 0; i < threads; ++i) workers.emplace_back(&FrameExporter::workerLoop, this);
+    return true;
+}
+
+void FrameExporter::submit(const void* pixels, int pitch) {
+    if (!running) return;
+    int slot;
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        if (freeSlots.empty()) {
+            Uint64 t0 = SDL_GetPerformanceCounter();
+            cvFree.wait(lk, [&]{ return !freeSlots.empty(); });
+            stallSec += (double)(SDL_GetPerformanceCounter() - t0) / (double)SDL_GetPerformanceFrequency();
+        }
+        slot = freeSlots.back(); freeSlots.pop_back();
+    }
+
+    // Copy ngoài khóa: slot thuộc riêng luồng render cho tới khi vào hàng đợi
+    Slot& s = slots[slot];
+    const Uint8* src = static_cast<const Uint8*>(pixels);
+    for (int y = 0; y < h; ++y) std::memcpy(&s.rgba[(size_t)y * w * 4], src + (size_t)y * pitch, (size_t)w * 4);
+    s.frameIndex = submitted++;
+
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        ready.push_back(slot);
+    }
+    cvReady.notify_one();
+}
+
+void FrameExporter::workerLoop() {
+    for (;;) {
+        int slot;
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            cvReady.wait(lk, [&]{ return stopping || !ready.empty(); });
+            if (ready.empty()) return;   // stopping và đã hết việc
+            slot = ready.front(); ready.pop_front();
+        }
+        encode(slots[slot]);
+        encoded.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            freeSlots.push_back(slot);
+        }
+        cvFree.notify_one();
+    }
+}
+
+void FrameExporter::encode(Slot& s) {
+    if (format == Format::Png) {
+        SDL_Surface* surf = SDL_CreateRGBSurfaceWithFormatFrom(s.rgba.data(), w, h, 32, w * 4, SDL_PIXELFORMAT_RGBA32);
+        if (!surf) return;
+        char name[32]; std::snprintf(name, sizeof(name), "/frame_%06d.png", s.frameIndex);
+        if (IMG_SavePNG(surf, (outPath + name).c_str()) != 0)
+            SDL_Log("FrameExporter: %s\n", IMG_GetError());
+        SDL_FreeSurface(surf);
+        return;
+    }
+
+    // RGBA -> RGB song song, rồi ghi theo đúng thứ tự frame
+    const Uint8* in = s.rgba.data();
+    Uint8* out = s.rgb.data();
+    for (size_t i = 0, n = (size_t)w * h; i < n; ++i, in += 4, out += 3) {
+        out[0] = in[0]; out[1] = in[1]; out[2] = in[2];
+    }
+    // Đợi tới lượt trên orderMtx riêng rồi ghi ngoài mọi khóa: chỉ luồng giữ nextToWrite được ghi,
+    // nên đĩa/pipe chậm chỉ giữ chân các encoder chứ không chặn submit()
+    {
+        std::unique_lock<std::mutex> lk(orderMtx);
+        cvOrder.wait(lk, [&]{ return nextToWrite == s.frameIndex; });
+    }
+    std::fwrite(s.rgb.data(), 1, s.rgb.size(), rawOut);
+    {
+        std::lock_guard<std::mutex> lk(orderMtx);
+        ++nextToWrite;
+    }
+    cvOrder.notify_all();
+}
+
+void FrameExporter::finish() {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        stopping = true;
+    }
+    cvReady.notify_all();
+    for (std::thread& t : workers) t.join();
+    workers.clear();
+
+    if (rawOut) {
+        std::fflush(rawOut);
+        if (rawOut != stdout) std::fclose(rawOut);
+        rawOut = nullptr;
+    }
+    running = false;
+
+    double sec = (double)(SDL_GetPerformanceCounter() - startCounter) / (double)SDL_GetPerformanceFrequency();
+    SDL_Log("FrameExporter: %d frames in %.2fs (%.1f frames/s), render stalled %.2fs waiting for encoders\n",
+            encoded.load(), sec, sec > 0.0 ? encoded.load() / sec : 0.0, stallSec);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdio>
+
+// Xuất frame offscreen: render loop chỉ copy pixel vào một slot rảnh rồi đi tiếp,
+// pool luồng encoder nén PNG (hoặc đổi sang RGB thô) song song và ghi đĩa/pipe.
+// Chỉ chặn render khi mọi slot đều đang bận (encoder chậm hơn render).
+class FrameExporter {
+public:
+    enum class Format { Png, RawRgb };
+
+    ~FrameExporter() { finish(); }
+
+    // out: thư mục PNG (frame_000000.png, ...) hoặc file/pipe RGB thô ("-" = stdout)
+    bool start(Format fmt, const std::string& out, int width, int height, int threads);
+
+    // Nộp 1 frame RGBA32 (pitch byte mỗi dòng)
+    void submit(const void* pixels, int pitch);
+
+    // Đợi encoder xử lý hết, đóng output và log thống kê
+    void finish();
+
+    bool active() const { return running; }
+    int  submittedFrames() const { return submitted; }
+    int  encodedFrames() const { return encoded.load(); }
+    double stallSeconds() const { return stallSec; }   // tổng thời gian render phải đợi slot
+
+private:
+    struct Slot {
+        std::vector<Uint8> rgba;
+        std::vector<Uint8> rgb;   // chỉ dùng cho RawRgb
+        int frameIndex = -1;
+    };
+
+    void workerLoop();
+    void encode(Slot& s);
+
+    Format format = Format::Png;
+    std::string outPath;
+    int w = 0, h = 0;
+    bool running = false;
+
+    std::vector<Slot> slots;
+    std::vector<int>  freeSlots;
+    std::deque<int>   ready;
+    std::vector<std::thread> workers;
+    std::mutex mtx;              // slot rảnh / hàng đợi: render chỉ giữ trong vài lệnh
+    std::condition_variable cvReady, cvFree;
+    bool stopping = false;
+
+    FILE* rawOut = nullptr;
+    std::mutex orderMtx;         // chỉ bảo vệ nextToWrite, không dính tới render
+    std::condition_variable cvOrder;
+    int   nextToWrite = 0;       // RawRgb phải ghi đúng thứ tự frame
+
+    int submitted = 0;
+    std::atomic<int> encoded{0};
+    double stallSec = 0.0;
+    Uint64 startCounter = 0;
+};
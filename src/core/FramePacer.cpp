@@ -0,0 +1,73 @@
+#include "core/FramePacer.hpp"
+#include "core/HiResClock.hpp"
+#include <algorithm>
+#include <cmath>
+
+void FramePacer::init(const Params& p) {
+    P = p;
+    vsyncPeriod = HiResClock::fromMs(1000.0 / std::max(1, P.refreshHz));
+    workEst = HiResClock::fromMs(2.0);
+    frameStart = lastPresent = deadline = 0;
+    activeFps = -1.0;
+    dtCount = dtHead = 0;
+}
+
+void FramePacer::waitForFrame(bool idle) {
+    double fps = (idle && P.idleFps > 0.0) ? P.idleFps : P.targetFps;
+    if (fps != activeFps) {
+        activeFps = fps;
+        deadline = 0;
+        dtCount = dtHead = 0;
+    }
+
+    if (lateSampling() && !idle && lastPresent) {
+        // low-latency: lùi thời điểm lấy mẫu input tới sát vsync kế tiếp
+        Uint64 budget = workEst + HiResClock::fromMs(P.marginMs);
+        if (budget < vsyncPeriod) HiResClock::sleepUntil(lastPresent + vsyncPeriod - budget, P.spinMs);
+    } else if (fps > 0.0) {
+        Uint64 period = HiResClock::fromMs(1000.0 / fps);
+        Uint64 now = HiResClock::now();
+        if (deadline == 0 || now > deadline + period) {
+            deadline = now;          // lần đầu hoặc trễ quá 1 frame: bắt nhịp lại, không dồn frame bù
+        } else {
+            HiResClock::sleepUntil(deadline, P.spinMs);
+        }
+        deadline += period;
+    }
+    frameStart = HiResClock::now();
+}
+
+void FramePacer::onPresented(Uint64 submitted, Uint64 presented) {
+    // ước lượng công việc: tăng ngay khi frame nặng hơn, giảm từ từ
+    Uint64 work = submitted > frameStart ? submitted - frameStart : 0;
+    if (work > workEst) workEst = work; else workEst -= (workEst - work) / 16;
+
+    if (P.vsync && lastPresent) {
+        // chỉ tin khoảng gần chu kỳ danh định (bỏ frame lỡ vsync / frame tiết kiệm điện)
+        Uint64 interval = presented - lastPresent;
+        if (interval > vsyncPeriod * 3 / 4 && interval < vsyncPeriod * 5 / 4)
+            vsyncPeriod = (Uint64)((Sint64)vsyncPeriod + ((Sint64)interval - (Sint64)vsyncPeriod) / 32);
+    }
+    lastPresent = presented;
+}
+
+float FramePacer::smooth(float rawDt) {
+    rawDt = std::min(std::max(rawDt, 0.f), 0.1f);   // kẹp khung giật (kéo cửa sổ, breakpoint...)
+    if (!P.smoothDt) return rawDt;
+
+    dts[dtHead] = rawDt;
+    dtHead = (dtHead + 1) % WINDOW;
+    if (dtCount < WINDOW) ++dtCount;
+    if (dtCount < 3) return rawDt;
+
+    float sum = 0.f, lo = dts[0], hi = dts[0];
+    for (int i = 0; i < dtCount; ++i) { sum += dts[i]; lo = std::min(lo, dts[i]); hi = std::max(hi, dts[i]); }
+    float avg = (sum - lo - hi) / (float)(dtCount - 2);
+
+    // vsync: nhịp thật là bội của chu kỳ màn hình -> bám đúng chu kỳ nếu lệch < 10%
+    if (P.vsync) {
+        float period = (float)HiResClock::toSeconds(vsyncPeriod);
+        if (std::fabs(avg - period) < period * 0.1f) return period;
+    }
+    return avg;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <SDL.h>
+
+// Điều nhịp frame trên HiResClock:
+//  - giới hạn FPS bằng ngủ + quay vòng (không đốt 100% CPU khi tắt vsync)
+//  - low-latency (vsync): ngủ tới sát vsync kế tiếp rồi mới lấy mẫu input
+//  - tiết kiệm điện: FPS thấp khi không có pha bóng (dừng sau bàn thắng, nghỉ giữa hiệp, pause)
+//  - làm mượt dt đưa vào mô phỏng
+class FramePacer {
+public:
+    struct Params {
+        bool   vsync = true;
+        int    refreshHz = 60;       // tần số màn hình (ước lượng ban đầu của chu kỳ vsync)
+        double targetFps = 0.0;      // 0 = không giới hạn (vsync tự điều nhịp nếu bật)
+        double idleFps = 20.0;       // 0 = tắt chế độ tiết kiệm
+        bool   lowLatency = false;   // chỉ có tác dụng khi vsync
+        double marginMs = 1.0;       // chừa trước vsync khi low-latency
+        double spinMs = 1.5;         // phần cuối quay vòng thay vì SDL_Delay
+        bool   smoothDt = true;
+    };
+
+    void init(const Params& p);
+
+    // Gọi đầu frame, trước khi poll event / lấy mẫu input
+    void waitForFrame(bool idle);
+    // Gọi quanh SDL_RenderPresent: submitted = lúc gửi lệnh vẽ xong, presented = lúc present trả về
+    void onPresented(Uint64 submitted, Uint64 presented);
+
+    // dt cho mô phỏng: trung bình cắt (bỏ min/max) của vài frame gần nhất, bám chu kỳ vsync nếu gần
+    float smooth(float rawDt);
+
+    bool lateSampling() const { return P.lowLatency && P.vsync; }
+
+private:
+    static const int WINDOW = 8;
+
+    Params P;
+    Uint64 vsyncPeriod = 0;   // tinh chỉnh theo khoảng present đo được
+    Uint64 workEst = 0;       // thời gian đầu frame -> submit
+    Uint64 frameStart = 0;
+    Uint64 lastPresent = 0;
+    Uint64 deadline = 0;      // mốc frame kế tiếp của bộ giới hạn FPS
+    double activeFps = -1.0;  // FPS giới hạn đang dùng (đổi -> reset nhịp + cửa sổ dt)
+
+    float  dts[WINDOW] = {};
+    int    dtCount = 0, dtHead = 0;
+};
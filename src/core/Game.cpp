@@ -1,4 +1,5 @@
 #include "core/Game.hpp"
+#include <filesystem>
 
 void Game::init(const Config& config, SDL_Renderer* renderer) {
     // Khởi tạo HUD với renderer
@@ -7,6 +8,7 @@ void Game::init(const Config& config, SDL_Renderer* renderer) {
     // Khởi tạo Scene trận đấu (truyền thêm renderer)
     currentScene = new MatchScene();
     currentScene->init(config, renderer, hud);
+    checkpointDir = config.checkpointDir;
 }
 
 void Game::update(float dt) {
@@ -23,6 +25,32 @@ void Game::render(SDL_Renderer* renderer) {
 
 void Game::togglePause() { paused = !paused; }
 
+bool Game::isIdle() const { return paused || (currentScene && currentScene->isIdle()); }
+
+bool Game::isFinished() const { return currentScene && currentScene->isFinished(); }
+
+void Game::invalidateStaticLayers() {
+    if (currentScene) currentScene->invalidateStaticLayer();
+}
+
+bool Game::quickSave() {
+    if (!currentScene) return false;
+    std::error_code ec;
+    std::filesystem::create_directories(checkpointDir, ec);
+    std::string path = checkpointDir + "/quick.tfac";
+    bool ok = currentScene->saveCheckpoint(path);
+    SDL_Log(ok ? "Checkpoint saved: %s\n" : "Checkpoint: cannot write %s\n", path.c_str());
+    return ok;
+}
+
+bool Game::quickLoad() {
+    if (!currentScene) return false;
+    std::string path = checkpointDir + "/quick.tfac";
+    bool ok = currentScene->loadCheckpoint(path);
+    SDL_Log(ok ? "Checkpoint loaded: %s\n" : "Checkpoint: cannot load %s\n", path.c_str());
+    return ok;
+}
+
 void Game::cleanup() {
     if (currentScene) { delete currentScene; currentScene = nullptr; }
     if (hud) { delete hud; hud = nullptr; }
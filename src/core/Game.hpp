@@ -16,6 +16,15 @@ public:
     void render(SDL_Renderer* renderer);
     // Chuyển đổi trạng thái Pause
     void togglePause();
+    // Không có pha bóng cần phản hồi nhanh (pause, dừng sau bàn thắng, nghỉ giữa hiệp, hết trận)
+    bool isIdle() const;
+    // Trận hiện tại đã kết thúc (FullTime)?
+    bool isFinished() const;
+    // Báo scene dựng lại các lớp nền cache (resize, mất render target)
+    void invalidateStaticLayers();
+    // Lưu / nạp checkpoint ô nhanh (<checkpoint.dir>/quick.tfac)
+    bool quickSave();
+    bool quickLoad();
     // Xóa dữ liệu game (xóa scene, hud)
     void cleanup();
 
@@ -27,4 +36,5 @@ private:
     MatchScene* currentScene = nullptr;
     HUD* hud = nullptr;
     bool paused = false;
+    std::string checkpointDir;
 };
@@ -0,0 +1,41 @@
+#pragma once
+#include <SDL.h>
+
+// Đồng hồ độ phân giải cao dựa trên SDL_GetPerformanceCounter (thay cho SDL_GetTicks tính bằng ms).
+// Mốc thời gian là số đếm thô (Uint64), đổi sang giây/ms khi cần.
+namespace HiResClock {
+
+inline Uint64 now() { return SDL_GetPerformanceCounter(); }
+
+inline Uint64 frequency() {
+    static const Uint64 freq = SDL_GetPerformanceFrequency();
+    return freq;
+}
+
+inline double toSeconds(Uint64 ticks) { return (double)ticks / (double)frequency(); }
+inline double toMs(Uint64 ticks)      { return (double)ticks * 1000.0 / (double)frequency(); }
+inline Uint64 fromMs(double ms)       { return (Uint64)(ms * (double)frequency() / 1000.0); }
+
+// Đổi timestamp (ms, theo SDL_GetTicks) của SDL_Event sang mốc HiResClock:
+// lùi "now" đúng bằng thời gian event đã nằm trong hàng đợi SDL
+inline Uint64 fromEventTimestamp(Uint32 eventMs) {
+    Uint64 t = now();
+    Uint32 age = SDL_GetTicks() - eventMs;
+    if (age > 1000) return t;   // timestamp lạ (0 hoặc bị wrap) -> dùng lúc nhận
+    Uint64 back = fromMs((double)age);
+    return back < t ? t - back : t;
+}
+
+// Ngủ tới mốc target: SDL_Delay phần thô, quay vòng spinMs cuối cho chính xác
+inline void sleepUntil(Uint64 target, double spinMs = 1.5) {
+    const Uint64 spin = fromMs(spinMs);
+    for (;;) {
+        Uint64 t = now();
+        if (t >= target) return;
+        Uint64 left = target - t;
+        if (left > spin) SDL_Delay((Uint32)toMs(left - spin));
+        else { while (now() < target) {} return; }
+    }
+}
+
+} // namespace HiResClock
@@ -1,4 +1,5 @@
 #include "core/Input.hpp"
+#include "core/HiResClock.hpp"
 #include <SDL_keyboard.h>
 
 static inline int mapKeyName(const std::string& name) {
@@ -48,10 +49,21 @@ void InputSystem::bindPlayers(Player* p1, Player* p2) {
     player1 = p1; player2 = p2;
 }
 
+bool InputSystem::isPlayerKey(SDL_Scancode code) const {
+    return code==scancodeP1_up || code==scancodeP1_down || code==scancodeP1_left || code==scancodeP1_right ||
+           code==scancodeP1_shoot || code==scancodeP1_slide || code==scancodeP1_switchGK ||
+           code==scancodeP2_up || code==scancodeP2_down || code==scancodeP2_left || code==scancodeP2_right ||
+           code==scancodeP2_shoot || code==scancodeP2_slide || code==scancodeP2_switchGK;
+}
+
 void InputSystem::handleEvent(const SDL_Event& e) {
     if (e.type==SDL_KEYDOWN && e.key.repeat==0) {
         SDL_Scancode code = e.key.keysym.scancode;
 
+        // Ghi mốc thời gian phím (theo timestamp của event, không phải lúc poll)
+        if (pendingCount < MAX_STAMPS && isPlayerKey(code))
+            pending[pendingCount++] = HiResClock::fromEventTimestamp(e.key.timestamp);
+
         // P1
         if (code==scancodeP1_shoot)      p1ShootPressed = true;
         else if (code==scancodeP1_slide) p1SlidePressed = true;
@@ -63,6 +75,8 @@ void InputSystem::handleEvent(const SDL_Event& e) {
         else if (code==scancodeP2_switchGK)   p2SwitchGKPressed = true;
 
         else if (e.key.keysym.sym==SDLK_ESCAPE) pausePressed = true;
+        else if (e.key.keysym.sym==SDLK_F5) savePressed = true;
+        else if (e.key.keysym.sym==SDLK_F9) loadPressed = true;
     }
 }
 
@@ -95,6 +109,12 @@ void InputSystem::update() {
         player2->in.switchGK = p2SwitchGKPressed;
     }
 
+    // các phím vừa chờ giờ đã vào mô phỏng
+    sampledAt = HiResClock::now();
+    sampledCount = pendingCount;
+    for (int i = 0; i < pendingCount; ++i) sampled[i] = pending[i];
+    pendingCount = 0;
+
     // one-frame reset
     p1ShootPressed=p1SlidePressed=p1SwitchGKPressed=false;
     p2ShootPressed=p2SlidePressed=p2SwitchGKPressed=false;
@@ -11,6 +11,12 @@ public:
     void update();
 
     bool pausePressed = false;
+    bool savePressed = false, loadPressed = false;   // F5 / F9: checkpoint ô nhanh
+
+    // Mốc HiResClock của các phím điều khiển được lấy mẫu ở lần update() gần nhất (đo độ trễ)
+    int sampledKeyCount() const { return sampledCount; }
+    const Uint64* sampledKeys() const { return sampled; }
+    Uint64 sampleTime() const { return sampledAt; }
 
 private:
     Player* player1 = nullptr;
@@ -27,4 +33,12 @@ private:
     // one-frame flags
     bool p1ShootPressed=false, p1SlidePressed=false, p1SwitchGKPressed=false;
     bool p2ShootPressed=false, p2SlidePressed=false, p2SwitchGKPressed=false;
+
+    // timestamp phím bấm chờ lấy mẫu / đã lấy mẫu
+    static const int MAX_STAMPS = 16;
+    Uint64 pending[MAX_STAMPS] = {};
+    Uint64 sampled[MAX_STAMPS] = {};
+    int pendingCount = 0, sampledCount = 0;
+    Uint64 sampledAt = 0;
+    bool isPlayerKey(SDL_Scancode code) const;
 };
@@ -1,15 +1,16 @@
 #pragma once
 #include <SDL.h>
+#include "core/HiResClock.hpp"
 
-// Timer đơn giản để tính delta time và quản lý frame
+// Timer đơn giản để tính delta time và quản lý frame (chạy trên HiResClock, không còn lượng tử 1 ms)
 class LTimer {
 public:
-    LTimer() : startTicks(0), pausedTicks(0), paused(false), started(false), vsync(false), lastTicks(0) {}
+    LTimer() : startTicks(0), pausedTicks(0), lastTicks(0), paused(false), started(false), vsync(false) {}
 
     void start() {
         started = true;
         paused = false;
-        startTicks = SDL_GetTicks();
+        startTicks = HiResClock::now();
         pausedTicks = 0;
         lastTicks = startTicks;
     }
@@ -25,7 +26,7 @@ public:
     void pause() {
         if (started && !paused) {
             paused = true;
-            pausedTicks = SDL_GetTicks() - startTicks;
+            pausedTicks = HiResClock::now() - startTicks;
             startTicks = 0;
         }
     }
@@ -33,22 +34,23 @@ public:
     void resume() {
         if (started && paused) {
             paused = false;
-            startTicks = SDL_GetTicks() - pausedTicks;
+            startTicks = HiResClock::now() - pausedTicks;
             pausedTicks = 0;
         }
     }
 
+    // Thời gian đã chạy (ms)
     Uint32 getTicks() const {
         if (started) {
-            if (paused) return pausedTicks;
-            else return SDL_GetTicks() - startTicks;
+            if (paused) return (Uint32)HiResClock::toMs(pausedTicks);
+            else return (Uint32)HiResClock::toMs(HiResClock::now() - startTicks);
         }
         return 0;
     }
 
     float getDeltaSeconds() {
-        Uint32 current = SDL_GetTicks();
-        float dt = (current - lastTicks) / 1000.0f;
+        Uint64 current = HiResClock::now();
+        float dt = (float)HiResClock::toSeconds(current - lastTicks);
         lastTicks = current;
         return dt;
     }
@@ -57,9 +59,9 @@ public:
     bool isVSync() const { return vsync; }
 
 private:
-    Uint32 startTicks;
-    Uint32 pausedTicks;
-    Uint32 lastTicks;
+    Uint64 startTicks;
+    Uint64 pausedTicks;
+    Uint64 lastTicks;
     bool paused;
     bool started;
     bool vsync;
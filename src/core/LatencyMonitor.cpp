@@ -0,0 +1,44 @@
+#include "core/LatencyMonitor.hpp"
+#include "core/HiResClock.hpp"
+#include <algorithm>
+
+void LatencyMonitor::Hist::add(double ms) {
+    int b = std::min(BINS - 1, std::max(0, (int)(ms * BINS_PER_MS)));
+    ++bins[b]; ++n; sum += ms;
+    maxMs = std::max(maxMs, ms);
+}
+
+double LatencyMonitor::Hist::percentile(double p) const {
+    if (n == 0) return 0.0;
+    uint64_t want = (uint64_t)(p * (double)(n - 1)) + 1, seen = 0;
+    for (int b = 0; b < BINS; ++b) {
+        seen += bins[b];
+        if (seen >= want) return (b + 0.5) / BINS_PER_MS;
+    }
+    return maxMs;
+}
+
+void LatencyMonitor::onFrame(const Uint64* keyStamps, int keyCount, Uint64 sampledAt, Uint64 presentedAt) {
+    for (int i = 0; i < keyCount; ++i) {
+        Uint64 s = keyStamps[i];
+        total.add(HiResClock::toMs(presentedAt > s ? presentedAt - s : 0));
+        queued.add(HiResClock::toMs(sampledAt > s ? sampledAt - s : 0));
+        ++count;
+    }
+}
+
+void LatencyMonitor::maybeReport(Uint64 now, float intervalSec) {
+    if (intervalSec <= 0.f) return;
+    if (lastReport == 0) { lastReport = now; return; }
+    if (HiResClock::toSeconds(now - lastReport) < intervalSec) return;
+    lastReport = now;
+    if (total.n) report("Latency");
+}
+
+void LatencyMonitor::report(const char* tag) const {
+    if (total.n == 0) { SDL_Log("%s: no key presses measured\n", tag); return; }
+    SDL_Log("%s: n=%llu input->present mean %.2f p50 %.2f p95 %.2f p99 %.2f max %.2f ms | "
+            "input->sample mean %.2f p95 %.2f ms\n", tag, (unsigned long long)total.n,
+            total.mean(), total.percentile(0.50), total.percentile(0.95), total.percentile(0.99), total.maxMs,
+            queued.mean(), queued.percentile(0.95));
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+
+// Đo độ trễ từ phím bấm tới frame đầu tiên phản ánh nó:
+//   event (timestamp của SDL) -> lấy mẫu input (InputSystem::update) -> present xong.
+// Histogram cố định 0.1 ms/cột nên ghi nhận O(1) và tính được p50/p95/p99 không cần lưu mẫu.
+class LatencyMonitor {
+public:
+    // Gọi sau SDL_RenderPresent: các phím lấy mẫu ở frame này đã lên màn hình
+    void onFrame(const Uint64* keyStamps, int keyCount, Uint64 sampledAt, Uint64 presentedAt);
+
+    // Log định kỳ (interval giây, 0 = không) và tổng kết cuối
+    void maybeReport(Uint64 now, float intervalSec);
+    void report(const char* tag) const;
+
+    uint64_t samples() const { return count; }
+
+private:
+    static const int BINS = 2000;          // 0..200 ms
+    static const int BINS_PER_MS = 10;
+
+    struct Hist {
+        uint32_t bins[BINS] = {};
+        uint64_t n = 0;
+        double   sum = 0.0, maxMs = 0.0;
+        void   add(double ms);
+        double percentile(double p) const;
+        double mean() const { return n ? sum / (double)n : 0.0; }
+    };
+
+    Hist total;      // event -> present
+    Hist queued;     // event -> lấy mẫu (thời gian chờ trong hàng đợi / tới frame kế)
+    uint64_t count = 0;
+    Uint64 lastReport = 0;
+};
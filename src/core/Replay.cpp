@@ -0,0 +1,51 @@
+#include "core/Replay.hpp"
+
+namespace Replay {
+
+bool Writer::open(const std::string& path, const Header& header) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    Header h = header;
+    h.magic = MAGIC; h.version = VERSION;
+    h.headerSize = sizeof(Header); h.frameSize = sizeof(Frame);
+    if (std::fwrite(&h, sizeof(h), 1, file) != 1) { close(); return false; }
+    count = 0;
+    return true;
+}
+
+void Writer::push(const Frame& f) {
+    if (!file) return;
+    // 32 byte/tick: ghi đồng bộ qua buffer của stdio là đủ rẻ, không cần luồng riêng như telemetry
+    if (std::fwrite(&f, sizeof(f), 1, file) == 1) ++count;
+}
+
+void Writer::close() {
+    if (file) { std::fclose(file); file = nullptr; }
+}
+
+bool Reader::open(const std::string& path) {
+    close();
+    file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    if (std::fread(&hdr, sizeof(hdr), 1, file) != 1 || hdr.magic != MAGIC || hdr.version != VERSION ||
+        hdr.frameSize != sizeof(Frame) || hdr.headerSize < sizeof(Header)) {
+        close();
+        return false;
+    }
+    std::fseek(file, (long)hdr.headerSize, SEEK_SET);
+    count = 0;
+    return true;
+}
+
+bool Reader::next(Frame& f) {
+    if (!file || std::fread(&f, sizeof(f), 1, file) != 1) return false;
+    ++count;
+    return true;
+}
+
+void Reader::close() {
+    if (file) { std::fclose(file); file = nullptr; }
+}
+
+} // namespace Replay
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// ===== Replay (.tfar): log input mỗi tick + băm trạng thái sau tick =====
+// [Header][Frame 0][Frame 1]...   Chạy lại = cùng seed + cùng dt + cùng input, rồi so băm từng tick:
+// tick đầu tiên lệch băm chính là chỗ mất tất định (không cần so cả dump trạng thái).
+namespace Replay {
+
+const uint32_t MAGIC   = 0x52414654u;   // "TFAR"
+const uint32_t VERSION = 1;
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t configHash;      // băm config lúc ghi (khác thì dễ lệch ngay từ đầu)
+    uint64_t seed;
+    uint32_t headerSize;
+    uint32_t frameSize;
+    uint32_t fixedPoint;      // ghi bằng build TFA_FIXED_POINT?
+    uint32_t reserved;
+};
+
+enum : uint8_t {
+    BTN_P1_SHOOT = 1, BTN_P1_SLIDE = 2, BTN_P1_SWITCH = 4,
+    BTN_P2_SHOOT = 8, BTN_P2_SLIDE = 16, BTN_P2_SWITCH = 32,
+    BTN_WIND = 64, BTN_WEATHER = 128        // phím '2' / '3' (đang giữ)
+};
+
+struct Frame {
+    float    dt;
+    float    p1x, p1y, p2x, p2y;
+    uint8_t  buttons;         // BTN_*
+    uint8_t  pad[3];
+    uint64_t stateHash;       // băm trạng thái SAU tick này
+};
+
+static_assert(sizeof(Header) == 40, "Replay::Header phải cố định 40 byte");
+static_assert(sizeof(Frame)  == 32, "Replay::Frame phải cố định 32 byte");
+
+class Writer {
+public:
+    ~Writer() { close(); }
+    bool open(const std::string& path, const Header& header);
+    void push(const Frame& f);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+    uint64_t frames() const { return count; }
+
+private:
+    FILE* file = nullptr;
+    uint64_t count = 0;
+};
+
+class Reader {
+public:
+    ~Reader() { close(); }
+    bool open(const std::string& path);
+    bool next(Frame& f);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+    const Header& header() const { return hdr; }
+    uint64_t position() const { return count; }   // số frame đã đọc
+
+private:
+    FILE* file = nullptr;
+    Header hdr{};
+    uint64_t count = 0;
+};
+
+} // namespace Replay
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Băm trạng thái mô phỏng mỗi tick: các hệ thống "đóng gói" trường của mình vào một khối byte
+// cố định (Packer), rồi băm cả khối bằng XXH64. Khối chỉ vài trăm byte nên chi phí ~ vài chục ns.
+// Float được băm theo bit: lệch 1 ulp cũng bị bắt (đúng mục đích phát hiện mất tất định).
+namespace StateHash {
+
+uint64_t xxh64(const void* data, size_t len, uint64_t seed = 0);
+
+class Packer {
+public:
+    static const size_t CAPACITY = 1024;
+
+    template <class T>
+    void put(const T& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "StateHash::Packer chỉ nhận kiểu POD");
+        if (size + sizeof(T) > CAPACITY) { overflow = true; return; }
+        std::memcpy(buf + size, &v, sizeof(T));
+        size += sizeof(T);
+    }
+
+    uint64_t digest(uint64_t seed = 0) const { return xxh64(buf, size, seed); }
+    size_t   bytes() const { return size; }
+    bool     overflowed() const { return overflow; }   // true = digest chỉ phủ CAPACITY byte đầu: bên gọi phải kiểm
+
+private:
+    unsigned char buf[CAPACITY];
+    size_t size = 0;
+    bool   overflow = false;
+};
+
+} // namespace StateHash
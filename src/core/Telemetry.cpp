@@ -0,0 +1,121 @@
+#include "core/Telemetry.hpp"
+#include "core/TelemetryCodec.hpp"
+#include <chrono>
+
+namespace Telemetry {
+
+Writer::Writer() = default;
+Writer::~Writer() { close(); }
+
+bool Writer::openFile(const std::string& path, const Header& header) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    hdr = header;
+    hdr.magic = MAGIC; hdr.version = VERSION;
+    hdr.headerSize = sizeof(Header); hdr.recordSize = sizeof(Record); hdr.indexSize = sizeof(IndexEntry);
+    hdr.bodyCount = BODY_COUNT;
+    if (hdr.indexInterval == 0) hdr.indexInterval = 256;
+    return true;
+}
+
+bool Writer::open(const std::string& path, const Header& header, uint32_t ringCapacity) {
+    if (!openFile(path, header)) return false;
+    encoder.reset();
+    std::fwrite(&hdr, sizeof(hdr), 1, file);
+    startThread(ringCapacity);
+    return true;
+}
+
+bool Writer::openCompressed(const std::string& path, const Header& header,
+                            const TelemetryCodec::Params& params, uint32_t ringCapacity) {
+    if (!openFile(path, header)) return false;
+    encoder.reset(new TelemetryCodec::Encoder());
+    encoded.clear();
+    encoder->begin(hdr, params, encoded);
+    drainEncoded();
+    startThread(ringCapacity);
+    return true;
+}
+
+void Writer::startThread(uint32_t ringCapacity) {
+    // dung lượng ring làm tròn lên lũy thừa 2 để dùng mask thay cho %
+    uint32_t cap = 2;
+    while (cap < ringCapacity) cap <<= 1;
+    ring.assign(cap, Record{});
+    mask = cap - 1;
+    head = 0; tail = 0; written = 0; droppedCount = 0;
+    stop = false;
+    thread = std::thread(&Writer::writerLoop, this);
+}
+
+void Writer::push(const Record& r) {
+    if (!file) return;
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) > mask) {   // đầy
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring[h & mask] = r;
+    head.store(h + 1, std::memory_order_release);
+}
+
+void Writer::drainEncoded() {
+    if (encoded.empty()) return;
+    std::fwrite(encoded.data(), 1, encoded.size(), file);
+    encoded.clear();
+}
+
+void Writer::writeRecord(const Record& r) {
+    if (encoder) {
+        encoder->add(r);      // chỉ sinh byte khi đủ một block
+        drainEncoded();
+        ++written;
+        return;
+    }
+    if (written % hdr.indexInterval == 0) {
+        IndexEntry e{};
+        e.magic = INDEX_MAGIC;
+        e.chunk = (uint32_t)(written / hdr.indexInterval);
+        e.firstRecord = written;
+        e.firstTick = r.tick; e.simTime = r.simTime;
+        e.state = r.state; e.half = r.half; e.scoreLeft = r.scoreLeft; e.scoreRight = r.scoreRight;
+        std::fwrite(&e, sizeof(e), 1, file);
+    }
+    std::fwrite(&r, sizeof(r), 1, file);
+    ++written;
+}
+
+void Writer::writerLoop() {
+    for (;;) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t h = head.load(std::memory_order_acquire);
+        if (t == h) {
+            if (stop.load(std::memory_order_acquire)) {
+                // producer đã dừng: rút nốt phần còn lại (nếu có) rồi thoát
+                if (head.load(std::memory_order_acquire) == t) break;
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            continue;
+        }
+        for (; t != h; ++t) writeRecord(ring[t & mask]);
+        tail.store(t, std::memory_order_release);
+    }
+}
+
+void Writer::close() {
+    if (!file) return;
+    stop.store(true, std::memory_order_release);
+    if (thread.joinable()) thread.join();
+    if (encoder) {
+        encoder->finish();
+        drainEncoded();
+        encoder.reset();
+    }
+    std::fclose(file);
+    file = nullptr;
+}
+
+} // namespace Telemetry
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+
+namespace TelemetryCodec { class Encoder; struct Params; }
+
+// ===== Định dạng file telemetry (.tfat) =====
+// [Header][Index 0][Record 0..N-1][Index 1][Record N..2N-1]...   (N = indexInterval)
+// Mọi phần có kích thước cố định nên vị trí record k tính được O(1), file chỉ ghi nối thêm
+// (không phải vá header lúc đóng) nên vẫn đọc được khi tiến trình chết giữa chừng.
+namespace Telemetry {
+
+const uint32_t MAGIC       = 0x54414654u;   // "TFAT"
+const uint32_t INDEX_MAGIC = 0x49414654u;   // "TFAI"
+const uint32_t VERSION     = 1;
+const int      BODY_COUNT  = 5;             // ball, p1, p2, gk1, gk2
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t configHash;      // băm nội dung config lúc ghi
+    uint64_t seed;            // seed của trận
+    uint32_t headerSize;
+    uint32_t recordSize;
+    uint32_t indexSize;
+    uint32_t indexInterval;   // số record giữa 2 index
+    uint32_t bodyCount;
+    float    fieldW, fieldH;
+    uint32_t reserved[3];
+};
+
+struct Body {
+    float px, py;
+    float vx, vy;
+};
+
+// Một tick mô phỏng
+struct Record {
+    uint32_t tick;
+    float    simTime;         // tổng thời gian mô phỏng (giây)
+    float    timeRemaining;   // đồng hồ hiệp
+    uint8_t  state;           // MatchState
+    uint8_t  half;
+    int8_t   ownerId;         // -1 = bóng tự do
+    int8_t   lastKickerId;
+    uint8_t  scoreLeft, scoreRight;
+    uint8_t  flags;           // FLAG_*
+    uint8_t  pad;
+    Body     bodies[BODY_COUNT];
+};
+
+enum : uint8_t { FLAG_WIND = 1, FLAG_WEATHER = 2 };
+
+// Index định kỳ: điểm đồng bộ + tóm tắt đầu mỗi khối để tua nhanh
+struct IndexEntry {
+    uint32_t magic;
+    uint32_t chunk;           // số thứ tự khối
+    uint64_t firstRecord;     // số record đứng trước khối này
+    uint32_t firstTick;
+    float    simTime;
+    uint8_t  state, half, scoreLeft, scoreRight;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(Header)     == 64,  "Telemetry::Header phải cố định 64 byte");
+static_assert(sizeof(Record)     == 100, "Telemetry::Record phải cố định 100 byte");
+static_assert(sizeof(IndexEntry) == 32,  "Telemetry::IndexEntry phải cố định 32 byte");
+
+// Offset của record k trong file
+inline uint64_t recordOffset(const Header& h, uint64_t k) {
+    uint64_t chunk = k / h.indexInterval;
+    return h.headerSize + (chunk + 1) * h.indexSize + k * h.recordSize;
+}
+
+// Ghi telemetry: mô phỏng push() vào ring SPSC không khóa (không bao giờ chặn),
+// luồng writer rút ring và ghi file. Ring đầy -> bỏ record và đếm lại.
+// openCompressed(): luồng writer nén luôn sang .tfaq (TelemetryCodec) thay vì ghi thô.
+class Writer {
+public:
+    Writer();
+    ~Writer();
+
+    bool open(const std::string& path, const Header& header, uint32_t ringCapacity = 4096);
+    bool openCompressed(const std::string& path, const Header& header,
+                        const TelemetryCodec::Params& params, uint32_t ringCapacity = 4096);
+    void push(const Record& r);
+    void close();
+
+    bool     isOpen() const { return file != nullptr; }
+    uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    bool openFile(const std::string& path, const Header& header);
+    void startThread(uint32_t ringCapacity);
+    void writerLoop();
+    void writeRecord(const Record& r);
+    void drainEncoded();
+
+    FILE*  file = nullptr;
+    Header hdr{};
+    uint64_t written = 0;
+
+    std::unique_ptr<TelemetryCodec::Encoder> encoder;   // null = ghi thô
+    std::vector<uint8_t> encoded;                       // byte nén chờ ghi
+
+    std::vector<Record> ring;
+    uint32_t mask = 0;
+    std::atomic<uint32_t> head{0};   // producer ghi
+    std::atomic<uint32_t> tail{0};   // consumer đọc
+    std::atomic<bool>     stop{false};
+    std::atomic<uint64_t> droppedCount{0};
+    std::thread thread;
+};
+
+} // namespace Telemetry
@@ -0,0 +1,275 @@
+#include "core/TelemetryCodec.hpp"
+#include "core/TelemetryReader.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace TelemetryCodec {
+
+static inline int bitLength(uint64_t x) {
+#if defined(__GNUC__)
+    return x ? 64 - __builtin_clzll(x) : 0;
+#else
+    int n = 0; while (x) { ++n; x >>= 1; } return n;
+#endif
+}
+
+static inline uint64_t zigzag(int64_t v)    { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static inline int64_t  unzigzag(uint64_t u) { return (int64_t)(u >> 1) ^ -(int64_t)(u & 1); }
+
+int32_t Quantizer::encode(float v) const {
+    v = std::min(std::max(v, lo), hi);
+    return (int32_t)std::lrint((double)(v - lo) * (double)inv);
+}
+
+// Dựng các bộ lượng tử từ kích thước sân + params (encoder và decoder gọi giống nhau)
+static void setupQuantizers(const Telemetry::Header& h, const Params& p,
+                            Quantizer& qx, Quantizer& qy, Quantizer& qv, Quantizer& qt, Quantizer& qc) {
+    qx.init(-p.margin, h.fieldW + p.margin, p.posStep);
+    qy.init(-p.margin, h.fieldH + p.margin, p.posStep);
+    qv.init(-p.velMax, p.velMax, p.velStep);
+    qt.init(0.f, 2.0e6f, 1e-3f);     // thời gian mô phỏng: bước 1 ms
+    qc.init(0.f, 2.0e6f, 1e-3f);     // đồng hồ hiệp: bước 1 ms
+}
+
+// Giá trị kênh của record (đã lượng tử)
+static void toChannels(const Telemetry::Record& r, const Quantizer& qx, const Quantizer& qy,
+                       const Quantizer& qv, const Quantizer& qt, const Quantizer& qc, int64_t* ch) {
+    ch[0] = r.tick;
+    ch[1] = qt.encode(r.simTime);
+    ch[2] = qc.encode(r.timeRemaining);
+    for (int i = 0; i < Telemetry::BODY_COUNT; ++i) {
+        const Telemetry::Body& b = r.bodies[i];
+        ch[3 + i*4 + 0] = qx.encode(b.px);
+        ch[3 + i*4 + 1] = qy.encode(b.py);
+        ch[3 + i*4 + 2] = qv.encode(b.vx);
+        ch[3 + i*4 + 3] = qv.encode(b.vy);
+    }
+}
+
+static inline int64_t predict(const PredictState& s, int c) {
+    if (s.n == 0) return 0;
+    if (s.n == 1) return s.h1[c];
+    return 2 * s.h1[c] - s.h2[c];
+}
+
+static inline void packBytes(const Telemetry::Record& r, uint8_t* b) {
+    b[0] = r.state; b[1] = r.half; b[2] = (uint8_t)r.ownerId; b[3] = (uint8_t)r.lastKickerId;
+    b[4] = r.scoreLeft; b[5] = r.scoreRight; b[6] = r.flags; b[7] = r.pad;
+}
+
+// ===================== Encoder =====================
+
+void Encoder::begin(const Telemetry::Header& source, const Params& p, std::vector<uint8_t>& o) {
+    out = &o; P = p;
+    if (P.keyframeInterval == 0) P.keyframeInterval = 256;
+    setupQuantizers(source, P, qx, qy, qv, qt, qc);
+
+    FileHeader fh{};
+    fh.magic = MAGIC; fh.version = VERSION; fh.source = source; fh.params = P;
+    const uint8_t* raw = reinterpret_cast<const uint8_t*>(&fh);
+    out->insert(out->end(), raw, raw + sizeof(fh));
+
+    ps.reset(); block.clear(); acc = 0; accBits = 0; total = 0;
+}
+
+void Encoder::putBits(uint64_t v, int n) {
+    // chia nhỏ để acc không tràn 64 bit
+    while (n > 32) { putBits(v >> (n - 32), 32); n -= 32; }
+    if (n <= 0) return;
+    acc = (acc << n) | (v & ((1ULL << n) - 1));
+    accBits += n;
+    while (accBits >= 8) {
+        block.push_back((uint8_t)(acc >> (accBits - 8)));
+        accBits -= 8;
+    }
+}
+
+void Encoder::putExpGolomb(uint64_t u) {
+    uint64_t x = u + 1;
+    int nb = bitLength(x);
+    putBits(0, nb - 1);
+    putBits(x, nb);
+}
+
+void Encoder::putSigned(int64_t v) { putExpGolomb(zigzag(v)); }
+
+void Encoder::add(const Telemetry::Record& r) {
+    if (ps.n == 0) blockFirstTick = r.tick;
+
+    uint8_t b[8]; packBytes(r, b);
+    if (ps.n == 0) {
+        for (int i = 0; i < 8; ++i) putBits(b[i], 8);
+    } else if (std::memcmp(b, ps.bytes, 8) == 0) {
+        putBits(0, 1);
+    } else {
+        putBits(1, 1);
+        for (int i = 0; i < 8; ++i) {
+            if (b[i] == ps.bytes[i]) putBits(0, 1);
+            else { putBits(1, 1); putBits(b[i], 8); }
+        }
+    }
+    std::memcpy(ps.bytes, b, 8);
+
+    int64_t ch[PredictState::CHANNELS];
+    toChannels(r, qx, qy, qv, qt, qc, ch);
+    for (int c = 0; c < PredictState::CHANNELS; ++c) {
+        putSigned(ch[c] - predict(ps, c));
+        ps.h2[c] = ps.h1[c]; ps.h1[c] = ch[c];
+    }
+    ++ps.n; ++total;
+
+    if (ps.n >= P.keyframeInterval) flushBlock();
+}
+
+void Encoder::flushBlock() {
+    if (ps.n == 0) return;
+    if (accBits > 0) putBits(0, 8 - accBits);   // căn byte cuối block
+
+    BlockHeader bh{};
+    bh.payloadBytes = (uint32_t)block.size();
+    bh.recordCount  = ps.n;
+    bh.firstTick    = blockFirstTick;
+    const uint8_t* raw = reinterpret_cast<const uint8_t*>(&bh);
+    out->insert(out->end(), raw, raw + sizeof(bh));
+    out->insert(out->end(), block.begin(), block.end());
+
+    block.clear(); acc = 0; accBits = 0;
+    ps.reset();
+}
+
+void Encoder::finish() { flushBlock(); }
+
+// ===================== Decoder =====================
+
+bool Decoder::open(const uint8_t* data, size_t sz) {
+    base = data; size = sz;
+    blocks.clear(); total = 0;
+    if (!data || size < sizeof(FileHeader)) return false;
+    std::memcpy(&hdr, data, sizeof(hdr));
+    if (hdr.magic != MAGIC || hdr.version != VERSION) return false;
+    setupQuantizers(hdr.source, hdr.params, qx, qy, qv, qt, qc);
+
+    // Bảng block: chỉ đọc header từng block, bỏ qua block cụt ở cuối
+    size_t off = sizeof(FileHeader);
+    while (off + sizeof(BlockHeader) <= size) {
+        BlockHeader bh; std::memcpy(&bh, base + off, sizeof(bh));
+        if (off + sizeof(bh) + bh.payloadBytes > size) break;
+        blocks.push_back(BlockRef{ off + sizeof(bh), total, bh.recordCount, bh.payloadBytes });
+        total += bh.recordCount;
+        off += sizeof(bh) + bh.payloadBytes;
+    }
+    return seek(0);
+}
+
+bool Decoder::startBlock(size_t b) {
+    if (b >= blocks.size()) { leftInBlock = 0; return false; }
+    curBlock = b;
+    leftInBlock = blocks[b].count;
+    rp   = base + blocks[b].offset;
+    rend = rp + blocks[b].bytes;
+    acc = 0; accBits = 0;
+    ps.reset();
+    return true;
+}
+
+bool Decoder::seek(uint64_t k) {
+    if (k >= total) { leftInBlock = 0; curBlock = blocks.size(); return total == 0 && k == 0; }
+    // block cuối cùng có firstRecord <= k
+    size_t b = (size_t)(std::upper_bound(blocks.begin(), blocks.end(), k,
+                        [](uint64_t v, const BlockRef& r){ return v < r.firstRecord; }) - blocks.begin()) - 1;
+    startBlock(b);
+    Telemetry::Record skip;
+    for (uint64_t i = blocks[b].firstRecord; i < k; ++i) next(skip);
+    return true;
+}
+
+uint64_t Decoder::getBits(int n) {
+    if (n > 32) { uint64_t hi = getBits(n - 32); return (hi << 32) | getBits(32); }
+    if (n <= 0) return 0;
+    while (accBits < n) {
+        acc = (acc << 8) | (rp < rend ? *rp++ : 0u);
+        accBits += 8;
+    }
+    uint64_t v = (acc >> (accBits - n)) & ((1ULL << n) - 1);
+    accBits -= n;
+    return v;
+}
+
+uint64_t Decoder::getExpGolomb() {
+    // đếm số bit 0 đứng đầu theo từng cửa sổ 32 bit
+    int zeros = 0;
+    for (;;) {
+        while (accBits < 32) { acc = (acc << 8) | (rp < rend ? *rp++ : 0u); accBits += 8; }
+        uint32_t w = (uint32_t)(acc >> (accBits - 32));
+        if (w != 0) {
+            int lz = 32 - bitLength(w);
+            zeros += lz; accBits -= lz;
+            break;
+        }
+        zeros += 32; accBits -= 32;
+        if (rp >= rend && zeros > 64) return 0;   // dữ liệu hỏng
+    }
+    return getBits(zeros + 1) - 1;
+}
+
+int64_t Decoder::getSigned() { return unzigzag(getExpGolomb()); }
+
+bool Decoder::next(Telemetry::Record& r) {
+    if (leftInBlock == 0) {
+        if (curBlock + 1 >= blocks.size() || !startBlock(curBlock + 1)) return false;
+    }
+
+    uint8_t b[8];
+    if (ps.n == 0) {
+        for (int i = 0; i < 8; ++i) b[i] = (uint8_t)getBits(8);
+    } else if (getBits(1) == 0) {
+        std::memcpy(b, ps.bytes, 8);
+    } else {
+        for (int i = 0; i < 8; ++i) b[i] = getBits(1) ? (uint8_t)getBits(8) : ps.bytes[i];
+    }
+    std::memcpy(ps.bytes, b, 8);
+
+    int64_t ch[PredictState::CHANNELS];
+    for (int c = 0; c < PredictState::CHANNELS; ++c) {
+        ch[c] = predict(ps, c) + getSigned();
+        ps.h2[c] = ps.h1[c]; ps.h1[c] = ch[c];
+    }
+    ++ps.n; --leftInBlock;
+
+    r.state = b[0]; r.half = b[1]; r.ownerId = (int8_t)b[2]; r.lastKickerId = (int8_t)b[3];
+    r.scoreLeft = b[4]; r.scoreRight = b[5]; r.flags = b[6]; r.pad = b[7];
+    r.tick          = (uint32_t)ch[0];
+    r.simTime       = qt.decode((int32_t)ch[1]);
+    r.timeRemaining = qc.decode((int32_t)ch[2]);
+    for (int i = 0; i < Telemetry::BODY_COUNT; ++i) {
+        Telemetry::Body& bd = r.bodies[i];
+        bd.px = qx.decode((int32_t)ch[3 + i*4 + 0]);
+        bd.py = qy.decode((int32_t)ch[3 + i*4 + 1]);
+        bd.vx = qv.decode((int32_t)ch[3 + i*4 + 2]);
+        bd.vy = qv.decode((int32_t)ch[3 + i*4 + 3]);
+    }
+    return true;
+}
+
+// ===================== Tiện ích file =====================
+
+bool compressFile(const std::string& tfatPath, const std::string& tfaqPath, const Params& p) {
+    TelemetryReader in;
+    if (!in.open(tfatPath)) return false;
+
+    std::vector<uint8_t> out;
+    Encoder enc;
+    enc.begin(in.header(), p, out);
+    in.forEach([&](const Telemetry::Record& r){ enc.add(r); });
+    enc.finish();
+
+    FILE* f = std::fopen(tfaqPath.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+    std::fclose(f);
+    return ok;
+}
+
+} // namespace TelemetryCodec
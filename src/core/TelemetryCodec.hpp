@@ -0,0 +1,130 @@
+#pragma once
+#include "core/Telemetry.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ===== Codec nén telemetry (.tfaq) =====
+// Lượng tử hóa vị trí/vận tốc theo biên sân (fieldW/fieldH + lề) với bước cấu hình được,
+// dự đoán bậc 2 (2*q[t-1] - q[t-2], chỉ dùng số nguyên nên encode/decode khớp bit),
+// phần dư zigzag + Exp-Golomb trong dòng bit. Thân nằm yên tốn ~1 bit mỗi thành phần.
+// File = [FileHeader][Block][Block]...; mỗi block bắt đầu lại dự đoán (keyframe) để tua nhanh.
+namespace TelemetryCodec {
+
+const uint32_t MAGIC   = 0x51414654u;   // "TFAQ"
+const uint32_t VERSION = 1;
+
+struct Params {
+    float    posStep  = 0.125f;    // px mỗi bước lượng tử vị trí
+    float    velStep  = 0.5f;      // px/s mỗi bước lượng tử vận tốc
+    float    margin   = 64.0f;     // lề ngoài sân vẫn giữ được (px), ngoài nữa bị kẹp
+    float    velMax   = 4096.0f;   // |v| tối đa (px/s)
+    uint32_t keyframeInterval = 256;   // số record mỗi block
+};
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    Telemetry::Header source;   // header telemetry gốc (seed, config hash, kích thước sân)
+    Params   params;
+    uint32_t reserved[3];
+};
+
+struct BlockHeader {
+    uint32_t payloadBytes;
+    uint32_t recordCount;
+    uint32_t firstTick;
+    uint32_t reserved;
+};
+
+// Lượng tử hóa của một trục
+struct Quantizer {
+    float lo = 0.f, hi = 0.f, step = 1.f, inv = 1.f;
+    void  init(float lo_, float hi_, float step_) { lo = lo_; hi = hi_; step = step_; inv = 1.0f / step_; }
+    int32_t encode(float v) const;
+    float   decode(int32_t q) const { return lo + (float)q * step; }
+};
+
+// Trạng thái dự đoán dùng chung cho encoder và decoder (phải giống hệt nhau)
+struct PredictState {
+    static const int CHANNELS = 3 + Telemetry::BODY_COUNT * 4;   // tick, time, clock, thân
+    int64_t h1[CHANNELS];
+    int64_t h2[CHANNELS];
+    uint8_t bytes[8];          // state, half, owner, kicker, scoreL, scoreR, flags, pad
+    uint32_t n = 0;            // số record đã có trong block
+    void reset() { n = 0; }
+};
+
+class Encoder {
+public:
+    // Ghi FileHeader vào out; mỗi lần đủ block sẽ nối block vào out
+    void begin(const Telemetry::Header& source, const Params& p, std::vector<uint8_t>& out);
+    void add(const Telemetry::Record& r);
+    void finish();   // ghi block dở dang
+
+    uint64_t recordCount() const { return total; }
+
+private:
+    void flushBlock();
+    void putBits(uint64_t v, int n);
+    void putExpGolomb(uint64_t u);
+    void putSigned(int64_t v);
+
+    std::vector<uint8_t>* out = nullptr;
+    Params P;
+    Quantizer qx, qy, qv, qt, qc;
+
+    PredictState ps;
+    std::vector<uint8_t> block;
+    uint64_t acc = 0; int accBits = 0;
+    uint32_t blockFirstTick = 0;
+    uint64_t total = 0;
+};
+
+// Giải mã từ vùng nhớ liền (ví dụ file map) — không copy dữ liệu nén
+class Decoder {
+public:
+    bool open(const uint8_t* data, size_t size);
+
+    const FileHeader& header() const { return hdr; }
+    uint64_t recordCount() const { return total; }
+
+    // Đặt con trỏ đọc về record k (nhảy tới block chứa nó rồi giải mã tiến)
+    bool seek(uint64_t k);
+    bool next(Telemetry::Record& r);
+
+    template <class Fn>
+    void forEach(Fn&& fn) {
+        Telemetry::Record r;
+        if (!seek(0)) return;
+        while (next(r)) fn(r);
+    }
+
+private:
+    struct BlockRef { size_t offset; uint64_t firstRecord; uint32_t count; uint32_t bytes; };
+
+    bool startBlock(size_t b);
+    uint64_t getBits(int n);
+    uint64_t getExpGolomb();
+    int64_t  getSigned();
+
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    FileHeader hdr{};
+    Quantizer qx, qy, qv, qt, qc;
+    std::vector<BlockRef> blocks;
+    uint64_t total = 0;
+
+    PredictState ps;
+    size_t curBlock = 0;
+    uint32_t leftInBlock = 0;
+    const uint8_t* rp = nullptr;   // con trỏ byte kế tiếp
+    const uint8_t* rend = nullptr;
+    uint64_t acc = 0; int accBits = 0;
+};
+
+// Nén 1 file .tfat (telemetry thô) thành .tfaq
+bool compressFile(const std::string& tfatPath, const std::string& tfaqPath, const Params& p);
+
+} // namespace TelemetryCodec
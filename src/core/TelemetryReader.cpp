@@ -0,0 +1,97 @@
+#include "core/TelemetryReader.hpp"
+#include <algorithm>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+using namespace Telemetry;
+
+bool TelemetryReader::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz; GetFileSizeEx(f, &sz);
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m) { CloseHandle(f); return false; }
+    base = static_cast<const unsigned char*>(MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0));
+    fileHandle = f; mapHandle = m;
+    size = (size_t)sz.QuadPart;
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { close(); return false; }
+    size = (size_t)st.st_size;
+    void* p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) { close(); return false; }
+    base = static_cast<const unsigned char*>(p);
+#endif
+    if (!base || size < sizeof(Header)) { close(); return false; }
+
+    hdr = reinterpret_cast<const Header*>(base);
+    if (hdr->magic != MAGIC || hdr->version != VERSION ||
+        hdr->recordSize != sizeof(Record) || hdr->indexSize != sizeof(IndexEntry) || hdr->indexInterval == 0 ||
+        hdr->headerSize != sizeof(Header) || hdr->headerSize > size) {   // file hỏng/cắt cụt: không để body âm
+        close(); return false;
+    }
+
+    // Số record suy từ kích thước file (bỏ qua record ghi dở ở cuối)
+    uint64_t body = size - hdr->headerSize;
+    uint64_t chunkBytes = (uint64_t)hdr->indexSize + (uint64_t)hdr->indexInterval * hdr->recordSize;
+    uint64_t full = body / chunkBytes, rest = body % chunkBytes;
+    records = full * hdr->indexInterval;
+    if (rest > hdr->indexSize) records += (rest - hdr->indexSize) / hdr->recordSize;
+    return true;
+}
+
+void TelemetryReader::close() {
+#ifdef _WIN32
+    if (base) UnmapViewOfFile(base);
+    if (mapHandle) CloseHandle((HANDLE)mapHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+    mapHandle = fileHandle = nullptr;
+#else
+    if (base) munmap(const_cast<unsigned char*>(base), size);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    base = nullptr; hdr = nullptr; size = 0; records = 0;
+}
+
+uint64_t TelemetryReader::chunkCount() const {
+    return hdr ? (records + hdr->indexInterval - 1) / hdr->indexInterval : 0;
+}
+
+const IndexEntry& TelemetryReader::chunk(uint64_t c) const {
+    uint64_t off = hdr->headerSize + c * ((uint64_t)hdr->indexSize + (uint64_t)hdr->indexInterval * hdr->recordSize);
+    return *reinterpret_cast<const IndexEntry*>(base + off);
+}
+
+uint64_t TelemetryReader::findTime(float t) const {
+    uint64_t chunks = chunkCount();
+    if (chunks == 0) return 0;
+    // khối cuối cùng có simTime đầu khối <= t
+    uint64_t lo = 0, hi = chunks;
+    while (hi - lo > 1) {
+        uint64_t mid = (lo + hi) / 2;
+        if (chunk(mid).simTime <= t) lo = mid; else hi = mid;
+    }
+    uint64_t k = lo * hdr->indexInterval;
+    uint64_t end = std::min<uint64_t>(records, k + hdr->indexInterval);
+    while (k < end && record(k).simTime < t) ++k;
+    return k;
+}
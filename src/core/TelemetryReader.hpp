@@ -0,0 +1,45 @@
+#pragma once
+#include "core/Telemetry.hpp"
+#include <string>
+#include <cstddef>
+
+// Đọc file telemetry bằng memory-map: record trả về là con trỏ thẳng vào vùng map (không copy).
+// Không phụ thuộc SDL để công cụ phân tích offline dùng lại được.
+class TelemetryReader {
+public:
+    TelemetryReader() = default;
+    ~TelemetryReader() { close(); }
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const Telemetry::Header& header() const { return *hdr; }
+    uint64_t recordCount() const { return records; }
+    uint64_t chunkCount() const;
+
+    // Truy cập ngẫu nhiên O(1)
+    const Telemetry::Record& record(uint64_t k) const {
+        return *reinterpret_cast<const Telemetry::Record*>(base + Telemetry::recordOffset(*hdr, k));
+    }
+    const Telemetry::IndexEntry& chunk(uint64_t c) const;
+
+    // Record đầu tiên có simTime >= t (tìm nhị phân trên index rồi trong khối)
+    uint64_t findTime(float t) const;
+
+    template <class Fn>
+    void forEach(Fn&& fn) const { for (uint64_t k = 0; k < records; ++k) fn(record(k)); }
+
+private:
+    const unsigned char* base = nullptr;
+    size_t size = 0;
+    const Telemetry::Header* hdr = nullptr;
+    uint64_t records = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mapHandle  = nullptr;
+#else
+    int fd = -1;
+#endif
+};
@@ -1,9 +1,10 @@
 #pragma once
 #include "ecs/Entity.hpp"
 #include "ui/Animation.hpp"
-#include <SDL_mixer.h>
 
 class Ball;
+class MatchEvents;
+class VoiceManager;
 
 struct InputIntent {
     float x = 0.f, y = 0.f;
@@ -12,34 +13,54 @@ struct InputIntent {
     bool switchGK = false;     // <== NÚT ĐỔI GK
 };
 
+// Dữ liệu trình bày (lạnh): animation 4 hướng + SFX, chỉ render/âm thanh đọc tới.
+// Scene giữ các PlayerVisual liền nhau; Player chỉ trỏ tới nên trạng thái mô phỏng gói trong 2 cache line.
+struct PlayerVisual {
+    Animation idle[4];
+    Animation run[4];
+    int dir = 0;                    // 0 xuống, 1 trái, 2 phải, 3 lên
+    VoiceManager* audio = nullptr;  // tiếng sút (không sở hữu; null = im lặng)
+
+    void update(const Vec2& vel, float dt);
+    SDL_Texture* frame(const Vec2& vel);   // idle hay chạy tùy vận tốc
+};
+
 class Player : public Entity {
 public:
-    // Input & control flags
+    // --- Nóng: đọc/ghi mỗi tick (input, applyInput, AI, tranh bóng) ---
     InputIntent in;
-    bool isControlled = false;   // đang do người chơi điều khiển?
-    bool isGoalkeeper = false;   // đây là GK?
-
-    // Movement/physics
+    Vec2  facing;
     float accel = 0.0f;
     float vmax  = 0.0f;
     float shootCooldown = 0.0f;
     float slideCooldown = 0.0f;
     float tackleTimer = 0.0f;
     bool  tackling = false;
-    Vec2  facing;
+    bool  isControlled = false;  // đang do người chơi điều khiển?
+    bool  isGoalkeeper = false;  // đây là GK?
 
-    // Animation
-    Animation idle[4];
-    Animation run[4];
-    int dir = 0;
+    // --- Ấm: trạng thái dắt bóng (assistDribble), chỉ đụng tới khi đang giữ bóng ---
+    struct DribbleState {
+        float clock=0.0f;
+        Vec2  aim=Vec2(1,0);
+        float tps=6.6f;
+        float touchSp=4.9f*40.0f;
+        float carryK=0.35f;
+        float turnR=3.0f;
+        float maxSp=5.2f*40.0f;
+        float minSp=1.0f*40.0f;
+        float extra=6.0f;
+        float tapBlend=0.58f;
+    } drb;
 
-    // SFX
-    Mix_Chunk* kickSfx = nullptr;
+    // --- Lạnh: nullptr = chạy không hình/tiếng (tool, mô phỏng rẽ nhánh) ---
+    PlayerVisual* visual = nullptr;
 
     Player();
     void applyInput(float dt);
-    bool tryShoot(Ball& ball);
-    void trySlide(Ball& ball, float dt);
+    // ev (tùy chọn): nhận sự kiện Shot / Tackle
+    bool tryShoot(Ball& ball, MatchEvents* ev = nullptr);
+    void trySlide(Ball& ball, float dt, MatchEvents* ev = nullptr);
     void assistDribble(Ball& ball, float dt);
     void updateAnim(float dt);
 };
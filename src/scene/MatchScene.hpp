@@ -7,7 +7,23 @@
 #include "ecs/Goal.hpp"
 #include "ecs/Goalkeeper.hpp"
 #include "sys/Physics.hpp"
+#include "sys/RenderQueue.hpp"
+#include "sys/Camera.hpp"
+#include "sys/TiledPitch.hpp"
+#include "sys/Particles.hpp"
+#include "sys/VoiceManager.hpp"
+#include "scene/systems/KeeperSystem.hpp"
+#include "scene/systems/WindField.hpp"
+#include "scene/systems/MatchEvents.hpp"
+#include "scene/systems/MatchStats.hpp"
+#include "scene/systems/SpatialIndex.hpp"
+#include "scene/systems/BallTrajectory.hpp"
+#include "util/Rng.hpp"
+#include "core/Telemetry.hpp"
+#include "core/Replay.hpp"
+#include "core/Checkpoint.hpp"
 #include <SDL_mixer.h>
+#include <string>
 
 // Các trạng thái của trận đấu
 enum class MatchState { Kickoff, Playing, GoalFreeze, HalfTimeBreak, FullTime };
@@ -32,18 +48,57 @@ public:
     Player* getPlayer1() { return &player1; }
     Player* getPlayer2() { return &player2; }
 
+    // Đánh dấu lớp nền tĩnh cần dựng lại (resize cửa sổ, mất render target, đổi config)
+    void invalidateStaticLayer() { staticDirty = true; }
+
+    bool isFinished() const { return state == MatchState::FullTime; }
+    bool isIdle() const {
+        return state == MatchState::GoalFreeze || state == MatchState::HalfTimeBreak || state == MatchState::FullTime;
+    }
+
+    // Seed của trận (để chạy lại y hệt)
+    uint64_t getSeed() const { return rng.getSeed(); }
+
+    const MatchStats& getStats() const { return stats; }
+
+    // Băm XXH64 toàn bộ trạng thái mô phỏng (gọi sau mỗi tick; rẻ, không cấp phát)
+    uint64_t stateHash() const;
+    uint64_t lastStateHash() const { return tickHash; }
+
+    // Checkpoint: chụp / khôi phục toàn bộ trạng thái mô phỏng (hiệp, đồng hồ, tỉ số, gió, thực thể, AI).
+    // forkSeed != 0: seed lại RNG sau khi nạp để các nhánh rẽ từ cùng một khoảnh khắc diễn biến khác nhau
+    void saveCheckpoint(Checkpoint::Image& img) const;
+    bool loadCheckpoint(const Checkpoint::Image& img, uint64_t forkSeed = 0);
+    bool saveCheckpoint(const std::string& path) const;
+    bool loadCheckpoint(const std::string& path);
+
 private:
     // Renderer & HUD
     SDL_Renderer* mRenderer = nullptr;
     HUD* hud = nullptr;
 
     // Asset (load 1 lần)
-    SDL_Texture* pitchTex = nullptr;
     SDL_Texture* ballTex  = nullptr;
     SDL_Texture* p1Tex    = nullptr;
     SDL_Texture* p2Tex    = nullptr;
     SDL_Texture* gkTex    = nullptr;
-    Mix_Chunk* goalSfx    = nullptr;
+
+    // Animation + SFX của p1, p2, gk1, gk2 (phần lạnh của Player, liền nhau ngoài thực thể)
+    PlayerVisual visuals[4];
+
+    // Lớp nền tĩnh (sân, vạch, cột gôn) được ghép sẵn vào 1 render target, mỗi frame chỉ blit 1 lần
+    SDL_Texture* staticLayer = nullptr;
+    int  staticW = 0, staticH = 0;
+    bool staticDirty = true;
+    void drawStaticLayer(SDL_Renderer* renderer, int sw, int sh);
+    void rebuildStaticLayer(SDL_Renderer* renderer, int sw, int sh);
+
+    // Lệnh vẽ của frame hiện tại (ghi trong render, flush 1 lần trước HUD)
+    RenderQueue renderQueue;
+    Camera camera;          // bám bóng khi sân lớn hơn cửa sổ; cull thực thể ngoài vùng nhìn
+    TiledPitch pitch;       // ảnh sân chia tile + mip, nạp theo vùng camera trong ngân sách texture
+    ParticleSystem particles; // vệt bóng, cỏ văng, pháo giấy (chỉ để nhìn, ngoài trạng thái mô phỏng)
+    VoiceManager audio;     // SFX: pool kênh cố định, ưu tiên + giới hạn tần suất, pan theo x
     Mix_Music* crowdMusic = nullptr;
 
     // Thông số thời gian hiệp
@@ -58,6 +113,23 @@ private:
     Goalkeeper gk2;
     Goals goals;            // quản lý khung thành và điểm số
     PhysicsSystem physics;  // hệ thống vật lý va chạm
+    KeeperSystem keeper;    // AI thủ môn (ngữ cảnh riêng của trận)
+    SpatialIndex spatial;   // chỉ mục không gian dựng 1 lần mỗi tick cho GK AI + tranh bóng
+    BallTrajectory ballPath; // quỹ đạo bóng dự đoán, dựng cùng lúc với spatial
+
+    // Ngẫu nhiên của trận: seed từ config (hoặc thời gian), mỗi loại một stream
+    MatchRng rng;
+    std::string resultsFile;
+    uint64_t configHash = 0;
+
+    // Sự kiện của tick hiện tại (các hệ thống push, update() rút 1 lần) + thống kê trận
+    MatchEvents events;
+    MatchStats  stats;
+    void drainEvents();
+
+    // Timer dùng chung giữa các hệ thống trong update()
+    float pickupCooldown = 0.f;
+    float gk1Hold = 0.f, gk2Hold = 0.f; // timer giữ bóng của GK
 
     // Trạng thái trận đấu
     MatchState state = MatchState::Kickoff;
@@ -97,10 +169,19 @@ private:
         // scale drag khi bật gió (slippery nhẹ)
         float dragScaleBall   = 0.60f;
         float dragScalePlayer = 0.70f;
+
+        // --- Weather mode: gió thay đổi theo vị trí trên sân ---
+        float fieldCellPx = 160.0f;  // kích thước ô lưới gió (px)
+        float turbulence  = 0.6f;    // biên độ nhiễu so với độ mạnh gió nền
+        float advectSpeed = 90.0f;   // tốc độ nhiễu trôi theo hướng gió (px/s)
+        float playerScale = 0.15f;   // cầu thủ chịu gió yếu hơn nhiều so với bóng
     } windCfg;
 
     bool extForces = false; // đang bật gió?
     bool key2Prev  = false; // rising-edge key '2'
+    bool weatherMode = false; // gió theo trường (key '3'), cần extForces
+    bool key3Prev  = false;
+    WindField windField;
 
     float baseBallDrag = 0.f;
     float baseP1Drag   = 0.f, baseP2Drag = 0.f;
@@ -110,5 +191,27 @@ private:
     float gustTimer  = 0.0f;      // đếm tới lần gust tiếp theo
     float windDirTimer = 0.0f;    // đếm tới lần đổi hướng/độ mạnh gió nền tiếp theo
 
-
+    // Bộ đếm tick + telemetry (ghi mỗi tick ở luồng riêng)
+    uint32_t tick = 0;
+    float    simTime = 0.f;
+    Telemetry::Writer telemetry;
+    void recordTelemetry();
+
+    // Replay: ghi input + băm mỗi tick, hoặc phát lại và so băm
+    uint64_t       tickHash = 0;
+    uint8_t        windKeys = 0;        // Replay::BTN_WIND / BTN_WEATHER của tick hiện tại
+    Replay::Writer replayOut;
+    Replay::Reader replayIn;
+    uint64_t       replayDesyncTick = 0;   // 0 = chưa lệch
+    bool beginReplayFrame(float& dt, Replay::Frame& fr);
+    void endReplayFrame(float dt, Replay::Frame& fr, bool playing);
+
+    // Một bước mô phỏng (update = simulate + ghi telemetry)
+    void simulate(float dt);
+
+    // Random gió nền + hẹn lần đổi hướng tiếp theo
+    void rollWind();
+
+    // Chuyển sang FullTime và ghi kết quả trận
+    void finishMatch();
 };
@@ -0,0 +1,106 @@
+#include "scene/systems/BallTrajectory.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const float MIN_DRAG = 1e-4f;   // drag = 0 -> coi như rất nhỏ để công thức vẫn dùng được
+static const float NO_HIT   = 1e30f;
+
+void BallTrajectory::setBounds(float fieldW, float fieldH, float y1, float y2){
+    W = fieldW; H = fieldH; goalY1 = y1; goalY2 = y2;
+}
+
+void BallTrajectory::build(const Ball& ball, float dt){
+    k = std::max(ball.drag, MIN_DRAG);
+    float q = detExp(-k * dt);
+    c = (dt > 0.f) ? dt * q / (1.0f - q) : 1.0f / k;
+    freeFlight = (ball.owner == nullptr);
+    goal = 0;
+
+    seg[0] = { 0.f, ball.tf.pos, ball.tf.vel };
+    segCount = 1;
+    if (!freeFlight) return;
+
+    const float r = ball.radius;
+    while (segCount < MAX_SEGMENTS) {
+        const Segment& s = seg[segCount - 1];
+        if (s.u.length2() < 1e-6f) break;
+
+        // quãng D tới mỗi tường (chỉ xét tường bóng đang lao tới và còn ở phía trong)
+        float hitY = NO_HIT, hitX = NO_HIT;
+        if      (s.u.y < 0.f) hitY = std::max(0.f, (r - s.p0.y) / s.u.y);
+        else if (s.u.y > 0.f) hitY = std::max(0.f, (H - r - s.p0.y) / s.u.y);
+        if      (s.u.x < 0.f && s.p0.x >= r)     hitX = (r - s.p0.x) / s.u.x;
+        else if (s.u.x > 0.f && s.p0.x <= W - r) hitX = (W - r - s.p0.x) / s.u.x;
+
+        float hit = std::min(hitX, hitY);
+        if (hit >= NO_HIT || s.d0 + hit >= c) break;    // dừng trước khi chạm tường
+
+        Segment n{ s.d0 + hit, s.p0 + s.u * hit, s.u };
+        if (hitX <= hitY) {
+            if (n.p0.y > goalY1 && n.p0.y < goalY2) {   // lọt khung thành: không nảy nữa
+                goal = (s.u.x < 0.f) ? -1 : 1;
+                break;
+            }
+            n.u.x = -n.u.x * ball.e_wall;
+        }
+        if (hitY <= hitX) n.u.y = -n.u.y * ball.e_wall;
+        seg[segCount++] = n;
+    }
+}
+
+float BallTrajectory::distAt(float t) const {
+    return -c * detExpm1(-k * std::max(t, 0.f));
+}
+
+float BallTrajectory::timeAtDist(float d) const {
+    if (d >= c) return NO_HIT;
+    return -detLog1p(-d / c) / k;
+}
+
+int BallTrajectory::segmentAt(float d) const {
+    int i = segCount - 1;
+    while (i > 0 && seg[i].d0 > d) --i;
+    return i;
+}
+
+Vec2 BallTrajectory::positionAt(float t) const {
+    float d = distAt(t);
+    const Segment& s = seg[segmentAt(d)];
+    return s.p0 + s.u * (d - s.d0);
+}
+
+Vec2 BallTrajectory::velocityAt(float t) const {
+    float d = distAt(t);
+    return seg[segmentAt(d)].u * detExp(-k * std::max(t, 0.f));
+}
+
+Vec2 BallTrajectory::restPoint() const {
+    const Segment& s = seg[segCount - 1];
+    return s.p0 + s.u * (c - s.d0);
+}
+
+float BallTrajectory::timeToSpeed(float minSpeed) const {
+    if (minSpeed <= 0.f) return NO_HIT;
+    for (int i = 0; i < segCount; ++i) {
+        float sp = seg[i].u.length();
+        float tStart = timeAtDist(seg[i].d0);
+        if (sp <= minSpeed) return tStart;              // nảy tường làm mất tốc ngay đầu đoạn
+        float t = detLog(sp / minSpeed) / k;
+        float tEnd = (i + 1 < segCount) ? timeAtDist(seg[i + 1].d0) : NO_HIT;
+        if (t < tEnd) return std::max(t, tStart);
+    }
+    return 0.f;
+}
+
+float BallTrajectory::timeToX(float lineX, float* yAt) const {
+    for (int i = 0; i < segCount; ++i) {
+        const Segment& s = seg[i];
+        if (std::abs(s.u.x) < 1e-6f) continue;
+        float d = s.d0 + (lineX - s.p0.x) / s.u.x;
+        float dEnd = (i + 1 < segCount) ? seg[i + 1].d0 : c;
+        if (d < s.d0 || d >= dEnd) continue;
+        if (yAt) *yAt = s.p0.y + s.u.y * (d - s.d0);
+        return timeAtDist(d);
+    }
+    return -1.f;
+}
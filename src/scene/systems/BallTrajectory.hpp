@@ -0,0 +1,53 @@
+#pragma once
+#include "util/Math.hpp"
+#include "ecs/Ball.hpp"
+
+// Quỹ đạo bay tự do của bóng, dựng 1 lần mỗi tick rồi cho AI truy vấn.
+// PhysicsSystem nhân vận tốc với q = exp(-drag*dt) rồi mới cộng vị trí, nên sau thời gian t
+// quãng đường "trải ra" là D(t) = c*(1 - e^{-drag*t}) với c = dt*q/(1-q) — khớp đúng tại các tick.
+// Trong không gian D, bóng đi thẳng giữa các lần nảy tường (e_wall), nên quỹ đạo là vài đoạn thẳng.
+// Bỏ qua: gió, va chạm cầu thủ/cột gôn, bóng đang có chủ (owner dắt bóng).
+class BallTrajectory {
+public:
+    static const int MAX_SEGMENTS = 6;   // đoạn đầu + tối đa 5 lần nảy
+
+    void setBounds(float fieldW, float fieldH, float goalY1, float goalY2);
+    void build(const Ball& ball, float dt);
+
+    // Vị trí / vận tốc sau t giây (t >= 0)
+    Vec2 positionAt(float t) const;
+    Vec2 velocityAt(float t) const;
+
+    // Điểm bóng dừng hẳn (giới hạn t -> vô cùng)
+    Vec2 restPoint() const;
+    // Thời điểm tốc độ xuống dưới minSpeed (0 nếu đã chậm hơn)
+    float timeToSpeed(float minSpeed) const;
+    // Thời điểm đầu tiên bóng cắt đường x = lineX, -1 nếu không bao giờ; yAt nhận tung độ lúc cắt
+    float timeToX(float lineX, float* yAt = nullptr) const;
+
+    int  bounces() const { return segCount - 1; }
+    // -1: bóng sẽ lọt gôn trái, +1: gôn phải, 0: không
+    int  goalSide() const { return goal; }
+    bool isFree() const { return freeFlight; }
+    float goalTop() const { return goalY1; }
+    float goalBottom() const { return goalY2; }
+
+private:
+    struct Segment {
+        float d0;   // quãng D lúc bắt đầu đoạn
+        Vec2  p0;   // vị trí đầu đoạn
+        Vec2  u;    // vận tốc "gốc" (chưa nhân e^{-drag*t}) trong đoạn
+    };
+
+    float W = 0.f, H = 0.f, goalY1 = 0.f, goalY2 = 0.f;
+    float k = 1.f;       // drag (s^-1)
+    float c = 1.f;       // D tối đa (t -> vô cùng)
+    Segment seg[MAX_SEGMENTS];
+    int   segCount = 1;
+    int   goal = 0;
+    bool  freeFlight = true;
+
+    float distAt(float t) const;   // D(t)
+    float timeAtDist(float d) const;
+    int   segmentAt(float d) const;
+};
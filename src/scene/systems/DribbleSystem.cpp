@@ -2,19 +2,6 @@
 
 static const float PI = 3.14159265358979323846f;
 
-Vec2 DribbleSystem::rotateTowards(const Vec2& a, const Vec2& b, float maxRad) {
-    Vec2 from = a.normalized(); if (from.length() < 1e-6f) from = Vec2(1,0);
-    Vec2 to   = b.normalized(); if (to.length()   < 1e-6f) to   = Vec2(1,0);
-    float dot = clampf(Vec2::dot(from,to), -1.0f, 1.0f);
-    float ang = std::acos(dot);
-    if (ang <= maxRad || ang < 1e-4f) return to;
-    float cross = from.x*to.y - from.y*to.x;
-    float sgn   = (cross >= 0.f) ? 1.f : -1.f;
-    float rot   = maxRad * sgn;
-    float cs = std::cos(rot), sn = std::sin(rot);
-    return Vec2(from.x*cs - from.y*sn, from.x*sn + from.y*cs);
-}
-
 // Critically-damped smoothing (không overshoot, ổn định số)
 Vec2 DribbleSystem::smoothDamp(const Vec2& current, const Vec2& target,
                                Vec2& vel, float smoothTime, float dt)
@@ -90,7 +77,7 @@ void DribbleSystem::update(Ball& ball, Player& h, float dt) {
     if (mag > 1.0f) v = v * (mag / std::max(1.0f, v.length()));
 
     // Khi đứng yên → dập vận tốc nhanh để tránh “đập đập”
-    if (!moving) v *= std::exp(-P.idleDamping * dt);
+    if (!moving) v *= detExp(-P.idleDamping * dt);
 
     ball.tf.vel = v;
 }
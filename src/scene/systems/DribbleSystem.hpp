@@ -42,7 +42,6 @@ private:
     static inline float clampf(float v, float lo, float hi) {
         return (v < lo) ? lo : (v > hi ? hi : v);
     }
-    static Vec2 rotateTowards(const Vec2& a, const Vec2& b, float maxRad);
 
     // SmoothDamp 2D (phiên bản ổn định số)
     static Vec2 smoothDamp(const Vec2& current, const Vec2& target,
@@ -2,46 +2,14 @@
 #include <algorithm>
 #include <cmath>
 
-static const float PI = 3.14159265358979323846f;
-
 float KeeperSystem::clampf(float v, float lo, float hi){ return (v<lo)?lo:((v>hi)?hi:v); }
 
-Vec2 KeeperSystem::rotateTowards(const Vec2& a, const Vec2& b, float maxRad) {
-    Vec2 from=a.normalized(); if (from.length()<1e-6f) from=Vec2(1,0);
-    Vec2 to  =b.normalized(); if (to.length()  <1e-6f) to  =Vec2(1,0);
-    float dot=clampf(Vec2::dot(from,to), -1.0f, 1.0f);
-    float ang=std::acos(dot);
-    if (ang<=maxRad || ang<1e-4f) return to;
-    float cross=from.x*to.y - from.y*to.x;
-    float sgn=(cross>=0.f)?1.f:-1.f;
-    float rot=maxRad*sgn;
-    float cs=std::cos(rot), sn=std::sin(rot);
-    return Vec2(from.x*cs - from.y*sn, from.x*sn + from.y*cs);
-}
-
-static inline float pointSegDist2(const Vec2& A, const Vec2& B, const Vec2& P, float& tOut){
-    Vec2 AB = B - A;
-    float L2 = AB.length2();
-    if (L2 < 1e-6f) { tOut = 0.0f; return (P - A).length2(); }
-    float t = Vec2::dot(P - A, AB) / L2;
-    // kẹp [0,1] mà không đụng hàm private
-    if (t < 0.0f) t = 0.0f; else if (t > 1.0f) t = 1.0f;
-    tOut = t;
-    Vec2 proj = A + AB * t;
-    return (P - proj).length2();
-}
-
-bool KeeperSystem::occludedBy(const Player& attacker, const Vec2& gkPos, const Vec2& ballPos, float margin){
-    float t; float d2=pointSegDist2(gkPos,ballPos,attacker.tf.pos,t);
-    float R=attacker.radius+margin;
-    return (t>0.05f && t<0.95f && d2<=R*R);
-}
-
 void KeeperSystem::updatePair(Ball& ball,
                               Player& gk1, Player& gk2,
                               Player& p1,  Player& p2,
                               float fieldW, float fieldH, float centerY, float dt,
-                              float& pickupCooldown)
+                              float& pickupCooldown, const SpatialIndex& index,
+                              const BallTrajectory& traj, MatchEvents* ev)
 {
     const float boxDepth  = fieldW * P.boxDepthRatio;
     const float leftEdge  = fieldW * 0.55f;
@@ -49,13 +17,14 @@ void KeeperSystem::updatePair(Ball& ball,
     bool ballInLeft  = (ball.tf.pos.x <= leftEdge);
     bool ballInRight = (ball.tf.pos.x >= rightEdge);
 
-    updateOne(ball, gk1, p1, p2, true,  ballInLeft,  ctx1, fieldW, fieldH, centerY, boxDepth, dt, pickupCooldown);
-    updateOne(ball, gk2, p2, p1, false, ballInRight, ctx2, fieldW, fieldH, centerY, boxDepth, dt, pickupCooldown);
+    updateOne(ball, gk1, p1, p2, true,  ballInLeft,  ctx1, fieldW, fieldH, centerY, boxDepth, dt, pickupCooldown, index, traj, ev);
+    updateOne(ball, gk2, p2, p1, false, ballInRight, ctx2, fieldW, fieldH, centerY, boxDepth, dt, pickupCooldown, index, traj, ev);
 }
 
 void KeeperSystem::updateOne(Ball& ball, Player& gk, Player& mate, Player& opp, bool leftSide,
                              bool activeSide, Ctx& C, float fieldW, float fieldH, float centerY,
-                             float boxDepth, float dt, float& pickupCooldown)
+                             float boxDepth, float dt, float& pickupCooldown, const SpatialIndex& index,
+                             const BallTrajectory& traj, MatchEvents* ev)
 {
     C.stTime += dt;
     float minX = leftSide ? 0.0f : (fieldW - boxDepth);
@@ -71,7 +40,20 @@ void KeeperSystem::updateOne(Ball& ball, Player& gk, Player& mate, Player& opp,
 
     Vec2 goalC   = leftSide ? Vec2(minX+12.0f, centerY) : Vec2(maxX-12.0f, centerY);
     Vec2 cutPt   = goalC + (ball.tf.pos - goalC) * 0.18f;
-    Vec2 intercp = ball.tf.pos + ball.tf.vel * 0.25f;
+    Vec2 intercp = traj.positionAt(0.25f);
+
+    // Cú sút đang bay về khung: đứng chờ ở điểm bóng sẽ cắt đường của GK (goalC.x)
+    bool shotIncoming = false; Vec2 blockPt = cutPt;
+    if (traj.isFree() && (leftSide ? ball.tf.vel.x < 0.f : ball.tf.vel.x > 0.f)) {
+        float yCross = 0.f;
+        float tCross = traj.timeToX(goalC.x, &yCross);
+        float margin = ball.radius + gk.radius;
+        if (tCross >= 0.f && tCross <= P.shotHorizon &&
+            yCross > traj.goalTop() - margin && yCross < traj.goalBottom() + margin) {
+            shotIncoming = true;
+            blockPt = Vec2(goalC.x, clampf(yCross, minY, maxY));
+        }
+    }
 
     const float MIN_CHARGE = 0.45f;
     if (C.st == Hold) {
@@ -98,11 +80,14 @@ void KeeperSystem::updateOne(Ball& ball, Player& gk, Player& mate, Player& opp,
         C.hold += dt;
         bool pressured = leftSide ? ((opp.tf.pos - gk.tf.pos).length() < 60.0f)
                                   : ((opp.tf.pos - gk.tf.pos).length() < 60.0f);
-        float ang = std::acos(clampf(Vec2::dot(fwd, desire), -1.0f, 1.0f));
-        const float READY = 10.0f*PI/180.0f;
+        // góc lệch < a  <=>  dot > cos(a): so thẳng tích vô hướng, không cần acos (libm)
+        float dot = Vec2::dot(fwd, desire);
+        const float COS_READY = 0.98480775f;   // cos 10°
+        const float COS_AIMED = 0.99452190f;   // cos 6°
 
-        if (C.hold>=P.maxHold || (pressured && ang<READY) || ang<(6.0f*PI/180.0f)) {
+        if (C.hold>=P.maxHold || (pressured && dot>COS_READY) || dot>COS_AIMED) {
             ball.owner=nullptr; ball.tf.vel = desire * P.clearSpeed;
+            if (ev) ev->push(MatchEvent::Shot, gk.id, -1, ball.tf.pos, ball.tf.vel);
             C.hold=0.f; C.st=Set; pickupCooldown=P.pickupCooldown;
         }
         return;
@@ -110,8 +95,8 @@ void KeeperSystem::updateOne(Ball& ball, Player& gk, Player& mate, Player& opp,
 
     // Move (Set/Charge)
     float walk = gk.vmax*P.walkFactor, rush = gk.vmax*P.rushFactor;
-    Vec2 target = (C.st==Set)? cutPt : intercp;
-    float speed = (C.st==Set)? walk  : rush;
+    Vec2 target = (C.st==Set)? (shotIncoming ? blockPt : cutPt) : intercp;
+    float speed = (C.st==Set && !shotIncoming)? walk : rush;
     Vec2 dirBall = (ball.tf.pos - gk.tf.pos).normalized();
     gk.facing = rotateTowards(gk.facing, dirBall, P.turnRate*dt);
 
@@ -134,11 +119,18 @@ void KeeperSystem::updateOne(Ball& ball, Player& gk, Player& mate, Player& opp,
     if (dist2 <= reach*reach) {
         bool nearFeet = ((ball.tf.pos - opp.tf.pos).length() <= (opp.radius + ball.radius + 12.0f)) ||
                         (ball.owner == &opp);
-        bool blocked  = occludedBy(opp, gk.tf.pos, ball.tf.pos, 6.0f) && nearFeet;
+        // đối thủ che đường GK -> bóng (vị trí đối thủ không đổi từ lúc dựng index)
+        bool blocked  = nearFeet &&
+                        index.segmentBlocker(gk.tf.pos, ball.tf.pos, 6.0f, SpatialIndex::only(opp.id)) >= 0;
 
         float v = ball.tf.vel.length();
         if (insideBox && !ball.owner && v <= P.catchSpeed && !blocked) {
-            ball.owner = &gk; C.st = Hold; C.hold = 0.f; return;
+            ball.owner = &gk; C.st = Hold; C.hold = 0.f;
+            if (ev) {
+                ev->push(MatchEvent::Save, gk.id, ball.lastKickerId, ball.tf.pos, ball.tf.vel);
+                ev->push(MatchEvent::Possession, gk.id, -1, ball.tf.pos, ball.tf.vel);
+            }
+            return;
         }
         // parry lệch hông attacker
         Vec2 nGK = (ball.tf.pos - gk.tf.pos).normalized();
@@ -147,6 +139,7 @@ void KeeperSystem::updateOne(Ball& ball, Player& gk, Player& mate, Player& opp,
         Vec2 outDir = (nGK*0.5f + side*0.8f).normalized();
         float outSp = std::min(P.parrySpeed, std::max(v, 6.0f*40.0f));
         if (!insideBox) outSp = P.parrySpeed;
+        if (ev) ev->push(MatchEvent::Parry, gk.id, ball.lastKickerId, ball.tf.pos, ball.tf.vel);
         ball.tf.vel = outDir * outSp;
     }
 }
@@ -1,6 +1,11 @@
 #pragma once
 #include "ecs/Player.hpp"
 #include "ecs/Ball.hpp"
+#include "scene/systems/MatchEvents.hpp"
+#include "scene/systems/SpatialIndex.hpp"
+#include "scene/systems/BallTrajectory.hpp"
+#include "core/StateHash.hpp"
+#include "core/Checkpoint.hpp"
 
 class KeeperSystem {
 public:
@@ -15,6 +20,7 @@ public:
         float clearSpeed      = 10.3f * 40.0f;
         float maxHold         = 2.5f;
         float pickupCooldown  = 0.25f;
+        float shotHorizon     = 1.2f;       // s: chỉ lao ra chặn cú sút sẽ tới vạch trong khoảng này
     };
 
     KeeperSystem() : P{} {}                   // ✅ mặc định
@@ -23,11 +29,30 @@ public:
 
     void reset() { ctx1 = Ctx{}; ctx2 = Ctx{}; }
 
+    // Ngữ cảnh 2 GK vào khối băm trạng thái
+    void packState(StateHash::Packer& pk) const {
+        for (const Ctx* c : { &ctx1, &ctx2 }) { pk.put((int32_t)c->st); pk.put(c->stTime); pk.put(c->hold); }
+    }
+
+    // Ngữ cảnh 2 GK <-> checkpoint (out[0]/in[0] = gk1)
+    void saveState(Checkpoint::KeeperState out[2]) const {
+        const Ctx* c[2] = { &ctx1, &ctx2 };
+        for (int i = 0; i < 2; ++i) out[i] = { (int32_t)c[i]->st, c[i]->stTime, c[i]->hold };
+    }
+    void loadState(const Checkpoint::KeeperState in[2]) {
+        Ctx* c[2] = { &ctx1, &ctx2 };
+        for (int i = 0; i < 2; ++i) {
+            c[i]->st = (in[i].st >= Set && in[i].st <= Hold) ? (GKState)in[i].st : Set;
+            c[i]->stTime = in[i].stTime; c[i]->hold = in[i].hold;
+        }
+    }
+
     void updatePair(Ball& ball,
                     Player& gk1, Player& gk2,
                     Player& p1,  Player& p2,
                     float fieldW, float fieldH, float centerY, float dt,
-                    float& pickupCooldown);
+                    float& pickupCooldown, const SpatialIndex& index,
+                    const BallTrajectory& traj, MatchEvents* ev = nullptr);
 
 private:
     enum GKState { Set, Charge, Hold };
@@ -36,11 +61,10 @@ private:
     Params P;
     Ctx ctx1, ctx2;
 
-    static bool  occludedBy(const Player& attacker, const Vec2& gkPos, const Vec2& ballPos, float margin);
     static float clampf(float v, float lo, float hi);
-    static Vec2  rotateTowards(const Vec2& a, const Vec2& b, float maxRad);
 
     void updateOne(Ball& ball, Player& gk, Player& mate, Player& opp, bool leftSide,
                    bool activeSide, Ctx& C, float fieldW, float fieldH, float centerY,
-                   float boxDepth, float dt, float& pickupCooldown);
+                   float boxDepth, float dt, float& pickupCooldown, const SpatialIndex& index,
+                   const BallTrajectory& traj, MatchEvents* ev);
 };
@@ -0,0 +1,41 @@
+#pragma once
+#include "util/Math.hpp"
+#include <cstdint>
+
+// Sự kiện trận đấu phát ra ngay tại chỗ xảy ra (sút, tắc bóng, bắt bóng...), gom trong 1 tick
+// rồi MatchScene rút một lần cho các bộ tiêu thụ (thống kê, ...).
+struct MatchEvent {
+    enum Type : uint8_t {
+        Possession,   // who vừa có bóng
+        Shot,         // who sút / phất bóng (pos, vel = bóng ngay sau cú đá)
+        Tackle,       // who xoạc trúng bóng, other = người đang giữ bóng trước đó (-1 nếu bóng tự do)
+        Save,         // thủ môn who bắt gọn
+        Parry,        // thủ môn who đẩy bóng ra
+        Goal          // who = id người chạm cuối, other = 0 đội trái ghi / 1 đội phải ghi
+    };
+    Type   type;
+    int8_t who;
+    int8_t other;
+    Vec2   pos;
+    Vec2   vel;
+};
+
+// Hàng đợi kích thước cố định (không cấp phát); đầy thì bỏ sự kiện mới
+class MatchEvents {
+public:
+    static const int CAPACITY = 64;
+
+    void push(MatchEvent::Type type, int who, int other, Vec2 pos, Vec2 vel) {
+        if (count >= CAPACITY) return;
+        items[count++] = MatchEvent{ type, (int8_t)who, (int8_t)other, pos, vel };
+    }
+    void clear() { count = 0; }
+
+    int size() const { return count; }
+    const MatchEvent* begin() const { return items; }
+    const MatchEvent* end()   const { return items + count; }
+
+private:
+    MatchEvent items[CAPACITY];
+    int count = 0;
+};
@@ -0,0 +1,117 @@
+#include "scene/systems/MatchStats.hpp"
+#include <cstdio>
+
+void MatchStats::reset(float fieldW_, float goalY1_, float goalY2_) {
+    *this = MatchStats{};
+    fieldW = fieldW_; goalY1 = goalY1_; goalY2 = goalY2_;
+}
+
+void MatchStats::saveState(Checkpoint::StatsState& out) const {
+    for (int s = 0; s < 2; ++s) {
+        const Side& d = sides[s];
+        out.sides[s] = { d.possession, d.shots, d.onTarget, d.saves, d.tackles, d.distance };
+    }
+    out.live = live; out.ctrlSide = ctrlSide; out.pendingShot = pendingShot; out.ctrlSince = ctrlSince;
+}
+
+void MatchStats::loadState(const Checkpoint::StatsState& in) {
+    for (int s = 0; s < 2; ++s) {
+        const Checkpoint::StatsState::Side& d = in.sides[s];
+        sides[s] = { d.possession, d.shots, d.onTarget, d.saves, d.tackles, d.distance };
+    }
+    live = in.live != 0; ctrlSide = in.ctrlSide; pendingShot = in.pendingShot; ctrlSince = in.ctrlSince;
+}
+
+void MatchStats::closePossession(float now) {
+    if (live && ctrlSide >= 0) sides[ctrlSide].possession += now - ctrlSince;
+    ctrlSince = now;
+}
+
+void MatchStats::setLive(bool live_, float now) {
+    if (live == live_) return;
+    closePossession(now);
+    live = live_;
+    if (live) ctrlSide = -1;   // giao bóng: chưa ai kiểm soát
+    pendingShot = -1;
+}
+
+// Sút: bóng phải hướng về khung đối phương và xuất phát từ nửa sân tấn công.
+// Trúng đích nếu đường thẳng theo vận tốc cắt vạch khung thành giữa 2 cột.
+void MatchStats::onShot(int side, const Vec2& pos, const Vec2& vel) {
+    float dir = side == 0 ? 1.f : -1.f;
+    if (vel.x * dir <= 0.f) return;
+    if ((pos.x - fieldW * 0.5f) * dir <= 0.f) return;
+
+    ++sides[side].shots;
+    float goalX = side == 0 ? fieldW : 0.f;
+    float yHit  = pos.y + vel.y * ((goalX - pos.x) / vel.x);
+    if (yHit >= goalY1 && yHit <= goalY2) {
+        ++sides[side].onTarget;
+        pendingShot = side;
+    } else {
+        pendingShot = -1;
+    }
+}
+
+void MatchStats::onEvent(const MatchEvent& e, float now) {
+    int side = sideOf(e.who);
+    switch (e.type) {
+    case MatchEvent::Possession:
+        // thủ môn đội kia nhặt được cú sút trúng đích cũng tính là cứu thua
+        if (pendingShot >= 0 && pendingShot != side && isKeeper(e.who)) ++sides[side].saves;
+        pendingShot = -1;
+        if (side != ctrlSide) { closePossession(now); ctrlSide = side; }
+        break;
+    case MatchEvent::Shot:
+        onShot(side, e.pos, e.vel);
+        break;
+    case MatchEvent::Tackle:
+        if (e.other >= 0 && sideOf(e.other) != side) ++sides[side].tackles;
+        break;
+    case MatchEvent::Save:
+    case MatchEvent::Parry:
+        // parry có thể phát nhiều tick liền khi bóng còn trong tầm tay: chỉ tính 1 lần mỗi cú sút
+        if (pendingShot >= 0 && pendingShot != side) ++sides[side].saves;
+        pendingShot = -1;
+        break;
+    case MatchEvent::Goal:
+        pendingShot = -1;
+        break;
+    }
+}
+
+float MatchStats::possessionShare(int s) const {
+    float total = sides[0].possession + sides[1].possession;
+    return total > 0.f ? sides[s].possession / total : 0.5f;
+}
+
+std::vector<std::string> MatchStats::summaryLines() const {
+    std::vector<std::string> out;
+    char buf[96];
+    const Side& L = sides[0];
+    const Side& R = sides[1];
+    std::snprintf(buf, sizeof buf, "Possession  %d%%  -  %d%%",
+                  (int)(possessionShare(0) * 100.f + 0.5f), (int)(possessionShare(1) * 100.f + 0.5f));
+    out.push_back(buf);
+    std::snprintf(buf, sizeof buf, "Shots (on target)  %d (%d)  -  %d (%d)", L.shots, L.onTarget, R.shots, R.onTarget);
+    out.push_back(buf);
+    std::snprintf(buf, sizeof buf, "Saves  %d  -  %d", L.saves, R.saves);
+    out.push_back(buf);
+    std::snprintf(buf, sizeof buf, "Tackles won  %d  -  %d", L.tackles, R.tackles);
+    out.push_back(buf);
+    std::snprintf(buf, sizeof buf, "Distance  %.2f km  -  %.2f km", L.distance / 40000.f, R.distance / 40000.f);   // PPM = 40
+    out.push_back(buf);
+    return out;
+}
+
+std::string MatchStats::toJsonFields() const {
+    char buf[512];
+    const Side& L = sides[0];
+    const Side& R = sides[1];
+    std::snprintf(buf, sizeof buf,
+        "\"possession\": [%.3f, %.3f], \"shots\": [%d, %d], \"on_target\": [%d, %d], "
+        "\"saves\": [%d, %d], \"tackles\": [%d, %d], \"distance_m\": [%.1f, %.1f]",
+        possessionShare(0), possessionShare(1), L.shots, R.shots, L.onTarget, R.onTarget,
+        L.saves, R.saves, L.tackles, R.tackles, L.distance / 40.f, R.distance / 40.f);
+    return buf;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "scene/systems/MatchEvents.hpp"
+#include "core/Checkpoint.hpp"
+#include <string>
+#include <vector>
+
+// Thống kê trận cộng dồn theo sự kiện: mỗi sự kiện O(1), không quét gì mỗi tick.
+// Đội 0 = bên trái (p1 id 1, gk1 id 3), đội 1 = bên phải (p2 id 2, gk2 id 4).
+class MatchStats {
+public:
+    struct Side {
+        float possession = 0.f;   // giây kiểm soát bóng (chỉ tính lúc bóng lăn)
+        int   shots      = 0;
+        int   onTarget   = 0;
+        int   saves      = 0;
+        int   tackles    = 0;     // xoạc lấy được bóng từ đối phương
+        float distance   = 0.f;   // px quãng đường cầu thủ + thủ môn chạy
+    };
+
+    void reset(float fieldW, float goalY1, float goalY2);
+
+    // Số liệu cộng dồn + khoảng kiểm soát bóng đang mở <-> checkpoint (kích thước sân giữ từ reset)
+    void saveState(Checkpoint::StatsState& out) const;
+    void loadState(const Checkpoint::StatsState& in);
+
+    // Bóng lăn / dừng (kickoff xong, bàn thắng, hết hiệp): đóng/mở khoảng tính kiểm soát bóng
+    void setLive(bool live, float now);
+    void onEvent(const MatchEvent& e, float now);
+
+    // Quãng đường: MatchScene cộng sau bước vật lý (4 phép cộng mỗi tick)
+    void addDistance(int side, float px) { sides[side].distance += px; }
+
+    const Side& side(int s) const { return sides[s]; }
+    float possessionShare(int s) const;
+
+    // Bảng tóm tắt cho HUD và chuỗi JSON (không có dấu ngoặc) cho file kết quả
+    std::vector<std::string> summaryLines() const;
+    std::string toJsonFields() const;
+
+    static int sideOf(int id) { return (id == 1 || id == 3) ? 0 : 1; }
+    static bool isKeeper(int id) { return id == 3 || id == 4; }
+
+private:
+    void closePossession(float now);
+    void onShot(int side, const Vec2& pos, const Vec2& vel);
+
+    Side  sides[2];
+    float fieldW = 0.f, goalY1 = 0.f, goalY2 = 0.f;
+
+    bool  live = false;
+    int   ctrlSide = -1;       // đội đang kiểm soát bóng (-1 = chưa ai)
+    float ctrlSince = 0.f;
+    int   pendingShot = -1;    // đội có cú sút trúng đích đang bay (chờ cứu thua / bàn thắng)
+};
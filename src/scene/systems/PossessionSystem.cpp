@@ -11,49 +11,74 @@ static bool inKeeperBox(const Ball& ball, const Player* gk, float fieldW, float
     return (ball.tf.pos.x >= minX && ball.tf.pos.x <= maxX);
 }
 
-static void tryTakeOne(Ball& ball, Player* p, float fieldW, float boxDepth, float pickupCooldown){
-    if (ball.owner) return;
+// Luật bắt bóng: thủ môn (chỉ trong vòng cấm, nón theo facing) và cầu thủ thường
+// (nón theo hướng dắt drb.aim, như luật cũ của assistDribble)
+struct CaptureRule { float coneDeg, rangeExtra, maxBallSpeed; };
+static const CaptureRule KEEPER_RULE  = { 60.0f, 10.0f, 3.5f * 40.0f };
+static const CaptureRule OUTFIELD_RULE = { 65.0f, 18.0f, 6.5f * 40.0f };
 
-    if (ball.justKicked > 0.0f && p->id == ball.lastKickerId) return;
-    if (pickupCooldown > 0.0f) return;
+// Trọng số chấm điểm: gần bóng quan trọng nhất, rồi tới hướng nhìn, rồi bóng chậm
+static const float W_DIST = 0.5f, W_FACING = 0.3f, W_SPEED = 0.2f;
 
-    Vec2 toBall = ball.tf.pos - p->tf.pos;
-    float d = toBall.length(); if (d < 1e-4f) return;
-
-    Vec2 fwd = p->facing.normalized();
-    float cosA = Vec2::dot(toBall * (1.0f/d), fwd);
-
-    bool isKeeper = p->isGoalkeeper;
-    if (isKeeper && !inKeeperBox(ball, p, fieldW, boxDepth)) return;
-
-    float captureRange = p->radius + ball.radius + (isKeeper ? 10.0f : 16.0f);
-    float maxBallSpeed = isKeeper ? (3.5f * 40.0f) : (6.0f * 40.0f);
+namespace PossessionSystem {
 
-    if (cosA > std::cos(60.0f * 3.14159265f/180.0f) &&
-        d < captureRange &&
-        ball.tf.vel.length() < maxBallSpeed)
-    {
-        ball.owner = p; // “ôm bóng” (GK) hay “dắt bóng” (cầu thủ) đều là owner
-    }
+float captureScore(const Ball& ball, const Player& p, float fieldW, float boxDepth)
+{
+    if (ball.justKicked > 0.0f && p.id == ball.lastKickerId) return -1.0f;
+
+    Vec2 toBall = ball.tf.pos - p.tf.pos;
+    float d = toBall.length(); if (d < 1e-4f) return -1.0f;
+
+    const CaptureRule& R = p.isGoalkeeper ? KEEPER_RULE : OUTFIELD_RULE;
+    if (p.isGoalkeeper && !inKeeperBox(ball, &p, fieldW, boxDepth)) return -1.0f;
+
+    float range = p.radius + ball.radius + R.rangeExtra;
+    if (d >= range) return -1.0f;
+    float v = ball.tf.vel.length();
+    if (v >= R.maxBallSpeed) return -1.0f;
+
+    Vec2 fwd = p.isGoalkeeper ? p.facing : p.drb.aim;
+    fwd = fwd.normalized();
+    if (fwd.length2() < 1e-6f) fwd = p.facing.normalized();
+    float coneCos = detCos(R.coneDeg * 3.14159265f / 180.0f);
+    float cosA = Vec2::dot(toBall * (1.0f / d), fwd);
+    if (cosA <= coneCos) return -1.0f;
+
+    float sDist   = 1.0f - d / range;
+    float sFacing = (cosA - coneCos) / (1.0f - coneCos);
+    float sSpeed  = 1.0f - v / R.maxBallSpeed;
+    return W_DIST * sDist + W_FACING * sFacing + W_SPEED * sSpeed;
 }
 
-namespace PossessionSystem {
-
-void tryTakeAll(Ball& ball,
-                Player& p1, Player& p2, Player& gk1, Player& gk2,
-                float fieldW, float boxDepth,
-                float& pickupCooldown, float dt)
+void tryTakeAll(Ball& ball, float fieldW, float boxDepth,
+                float& pickupCooldown, float dt,
+                const SpatialIndex& index, float slack, MatchEvents* ev)
 {
     pickupCooldown = std::max(0.0f, pickupCooldown - dt);
     ball.justKicked = std::max(0.0f, ball.justKicked - dt);
-
-    tryTakeOne(ball, &p1, fieldW, boxDepth, pickupCooldown);
-    tryTakeOne(ball, &p2, fieldW, boxDepth, pickupCooldown);
-    tryTakeOne(ball, &gk1, fieldW, boxDepth, pickupCooldown);
-    tryTakeOne(ball, &gk2, fieldW, boxDepth, pickupCooldown);
+    if (ball.owner || pickupCooldown > 0.0f) return;
+
+    // tầm bắt lớn nhất = bán kính lớn nhất + bóng + phần cộng lớn nhất của các luật
+    float reach = index.maxBodyRadius() + ball.radius +
+                  std::max(KEEPER_RULE.rangeExtra, OUTFIELD_RULE.rangeExtra) + slack;
+
+    // chấm điểm ngay khi duyệt: không có mảng ứng viên nên không giới hạn số cầu thủ
+    Player* best = nullptr; float bestScore = 0.0f;
+    index.forEachWithin(ball.tf.pos, reach, SpatialIndex::group(SpatialIndex::GroupPlayer),
+                        [&](const SpatialIndex::Item& it) {
+        Player* p = static_cast<Player*>(it.e);   // GroupPlayer chỉ gán cho Player
+        float s = captureScore(ball, *p, fieldW, boxDepth);
+        if (s < 0.0f) return;
+        if (!best || s > bestScore || (s == bestScore && p->id < best->id)) { best = p; bestScore = s; }
+    });
+    if (!best) return;
+
+    ball.owner = best; // “ôm bóng” (GK) hay “dắt bóng” (cầu thủ) đều là owner
+    if (!best->isGoalkeeper) best->drb.clock = 0.0f;
+    if (ev) ev->push(MatchEvent::Possession, best->id, -1, ball.tf.pos, ball.tf.vel);
 }
 
-void updateKeeperBallLogic(Ball& ball, Player& gk, float& holdTimer, float dt)
+void updateKeeperBallLogic(Ball& ball, Player& gk, float& holdTimer, float dt, MatchEvents* ev)
 {
     if (!gk.isGoalkeeper) return;
 
@@ -76,6 +101,7 @@ void updateKeeperBallLogic(Ball& ball, Player& gk, float& holdTimer, float dt)
             ball.tf.vel = aim * kick + gk.tf.vel * 0.3f;
             ball.lastKickerId = gk.id;
             ball.justKicked   = 0.30f;
+            if (ev) ev->push(MatchEvent::Shot, gk.id, -1, ball.tf.pos, ball.tf.vel);
         }
     } else {
         holdTimer = 0.0f;
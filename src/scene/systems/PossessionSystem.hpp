@@ -1,13 +1,20 @@
 #pragma once
 #include "ecs/Player.hpp"
 #include "ecs/Ball.hpp"
+#include "scene/systems/MatchEvents.hpp"
+#include "scene/systems/SpatialIndex.hpp"
 
 namespace PossessionSystem {
-    void tryTakeAll(Ball& ball,
-                    Player& p1, Player& p2, Player& gk1, Player& gk2,
-                    float fieldW, float boxDepth,
-                    float& pickupCooldown, float dt);
+    // Phân xử giành bóng 1 lượt, không phụ thuộc thứ tự: mọi thực thể GroupPlayer trong index (nới
+    // thêm slack = quãng cầu thủ đã đi kể từ lúc dựng index) được chấm điểm theo khoảng cách, góc nhìn
+    // và tốc độ bóng trên vị trí hiện tại; điểm cao nhất thắng, hòa thì id nhỏ hơn. Không giới hạn số cầu thủ.
+    void tryTakeAll(Ball& ball, float fieldW, float boxDepth,
+                    float& pickupCooldown, float dt,
+                    const SpatialIndex& index, float slack, MatchEvents* ev = nullptr);
+
+    // Điểm nhận bóng của p (0..1), < 0 nếu không đủ điều kiện
+    float captureScore(const Ball& ball, const Player& p, float fieldW, float boxDepth);
 
     // GK ôm bóng: giữ bóng trước tay, auto phất sau X giây, hoặc phất khi bấm shoot
-    void updateKeeperBallLogic(Ball& ball, Player& gk, float& holdTimer, float dt);
+    void updateKeeperBallLogic(Ball& ball, Player& gk, float& holdTimer, float dt, MatchEvents* ev = nullptr);
 }
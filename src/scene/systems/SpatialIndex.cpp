@@ -0,0 +1,158 @@
+#include "scene/systems/SpatialIndex.hpp"
+#include <algorithm>
+#include <cmath>
+
+static const float OUTSIDE = 64.f;   // lề ngoài sân vẫn có ô riêng
+
+void SpatialIndex::init(float fieldW, float fieldH, float cellSize) {
+    cell = std::max(8.f, cellSize);
+    invCell = 1.f / cell;
+    originX = -OUTSIDE; originY = -OUTSIDE;
+    cols = std::max(1, (int)std::ceil((fieldW + 2.f * OUTSIDE) * invCell));
+    rows = std::max(1, (int)std::ceil((fieldH + 2.f * OUTSIDE) * invCell));
+    cellStart.assign((size_t)cols * rows + 1, 0);
+    items.clear();
+}
+
+int SpatialIndex::cellX(float x) const { return std::min(cols - 1, std::max(0, (int)((x - originX) * invCell))); }
+int SpatialIndex::cellY(float y) const { return std::min(rows - 1, std::max(0, (int)((y - originY) * invCell))); }
+
+void SpatialIndex::build(Entity* const* bodies, int n, const uint32_t* flags) {
+    // counting sort theo ô: đếm -> cộng dồn -> rải (không cấp phát sau lần đầu)
+    std::fill(cellStart.begin(), cellStart.end(), 0u);
+    cellOf.resize(n);
+    items.resize(n);
+    maxRadius = 0.f;
+    for (int i = 0; i < n; ++i) {
+        const Vec2& p = bodies[i]->tf.pos;
+        uint32_t c = (uint32_t)(cellY(p.y) * cols + cellX(p.x));
+        cellOf[i] = c;
+        ++cellStart[c + 1];
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) cellStart[c] += cellStart[c - 1];
+
+    cursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < n; ++i) {
+        Entity* e = bodies[i];
+        items[cursor[cellOf[i]]++] = Item{ e->tf.pos.x, e->tf.pos.y, e->radius, e->id, flags ? flags[i] : ~0u, e };
+        maxRadius = std::max(maxRadius, e->radius);
+    }
+}
+
+const SpatialIndex::Item* SpatialIndex::find(int id) const {
+    for (const Item& it : items) if (it.id == id) return &it;
+    return nullptr;
+}
+
+int SpatialIndex::withinRadius(const Vec2& p, float radius, const Item** out, int cap, Filter f) const {
+    int count = 0;
+    forEachWithin(p, radius, f, [&](const Item& it) { if (count < cap) out[count++] = &it; });
+    return count;
+}
+
+int SpatialIndex::withinRadius(const Vec2& p, float radius, int* out, int cap, Filter f) const {
+    int count = 0;
+    forEachWithin(p, radius, f, [&](const Item& it) { if (count < cap) out[count++] = it.id; });
+    return count;
+}
+
+int SpatialIndex::withinCone(const Vec2& origin, const Vec2& dir, float cosHalf, float range,
+                             int* out, int cap, Filter f) const {
+    int x0 = cellX(origin.x - range), x1 = cellX(origin.x + range);
+    int y0 = cellY(origin.y - range), y1 = cellY(origin.y + range);
+    float r2 = range * range, c2 = cosHalf * cosHalf;
+    int count = 0;
+    for (int cy = y0; cy <= y1; ++cy)
+        for (int cx = x0; cx <= x1; ++cx) {
+            int c = cy * cols + cx;
+            for (uint32_t k = cellStart[c]; k < cellStart[c + 1]; ++k) {
+                const Item& it = items[k];
+                if (!f.pass(it)) continue;
+                float dx = it.x - origin.x, dy = it.y - origin.y;
+                float d2 = dx * dx + dy * dy;
+                if (d2 > r2) continue;
+                // cos(góc) >= cosHalf  <=>  dot >= cosHalf*|d|  (so bình phương để khỏi sqrt)
+                float dot = dx * dir.x + dy * dir.y;
+                bool inside = (d2 < 1e-8f) ||
+                              (cosHalf >= 0.f ? (dot > 0.f && dot * dot >= c2 * d2)
+                                              : (dot >= 0.f || dot * dot <= c2 * d2));
+                if (inside && count < cap) out[count++] = it.id;
+            }
+        }
+    return count;
+}
+
+int SpatialIndex::nearest(const Vec2& p, int n, int* out, Filter f) const {
+    if (n <= 0) return 0;
+    // tìm theo vành ô mở rộng dần; dừng khi vành kế tiếp chắc chắn xa hơn phần tử thứ n
+    struct Hit { float d2; int id; };
+    n = std::min(n, (int)items.size());
+    if (n <= 0) return 0;
+    Hit local[32];
+    std::vector<Hit> heap;               // chỉ cấp phát khi hỏi nhiều hơn 32
+    if (n > 32) heap.resize(n);
+    Hit* best = (n > 32) ? heap.data() : local;
+    int found = 0;
+    int cx0 = cellX(p.x), cy0 = cellY(p.y);
+    int maxRing = std::max(cols, rows);
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        for (int cy = cy0 - ring; cy <= cy0 + ring; ++cy) {
+            if (cy < 0 || cy >= rows) continue;
+            bool edgeRow = (cy == cy0 - ring || cy == cy0 + ring);
+            for (int cx = cx0 - ring; cx <= cx0 + ring; cx += (edgeRow ? 1 : 2 * ring)) {
+                if (cx >= 0 && cx < cols) {
+                    int c = cy * cols + cx;
+                    for (uint32_t k = cellStart[c]; k < cellStart[c + 1]; ++k) {
+                        const Item& it = items[k];
+                        if (!f.pass(it)) continue;
+                        float dx = it.x - p.x, dy = it.y - p.y;
+                        Hit h{ dx * dx + dy * dy, it.id };
+                        // chèn giữ thứ tự tăng dần, giữ tối đa n
+                        int pos = std::min(found, n - 1);
+                        if (found == n && h.d2 >= best[n - 1].d2) continue;
+                        while (pos > 0 && (best[pos - 1].d2 > h.d2 || (best[pos - 1].d2 == h.d2 && best[pos - 1].id > h.id))) {
+                            best[pos] = best[pos - 1]; --pos;
+                        }
+                        best[pos] = h;
+                        if (found < n) ++found;
+                    }
+                }
+                if (ring == 0) break;
+            }
+        }
+        // mọi ô chưa xét cách p ít nhất ring*cell
+        if (found == n) {
+            float reach = ring * cell;
+            if (reach * reach >= best[n - 1].d2) break;
+        }
+    }
+    for (int i = 0; i < found; ++i) out[i] = best[i].id;
+    return found;
+}
+
+int SpatialIndex::segmentBlocker(const Vec2& a, const Vec2& b, float margin, Filter f,
+                                 float tMin, float tMax) const {
+    float pad = maxRadius + margin;
+    int x0 = cellX(std::min(a.x, b.x) - pad), x1 = cellX(std::max(a.x, b.x) + pad);
+    int y0 = cellY(std::min(a.y, b.y) - pad), y1 = cellY(std::max(a.y, b.y) + pad);
+    Vec2 ab = b - a;
+    float L2 = ab.length2();
+    if (L2 < 1e-6f) return -1;
+    float invL2 = 1.f / L2;
+
+    int bestId = -1; float bestT = 2.f;
+    for (int cy = y0; cy <= y1; ++cy)
+        for (int cx = x0; cx <= x1; ++cx) {
+            int c = cy * cols + cx;
+            for (uint32_t k = cellStart[c]; k < cellStart[c + 1]; ++k) {
+                const Item& it = items[k];
+                if (!f.pass(it)) continue;
+                float t = ((it.x - a.x) * ab.x + (it.y - a.y) * ab.y) * invL2;
+                if (t <= tMin || t >= tMax) continue;
+                float px = a.x + ab.x * t - it.x, py = a.y + ab.y * t - it.y;
+                float R = it.r + margin;
+                if (px * px + py * py <= R * R && t < bestT) { bestT = t; bestId = it.id; }
+            }
+        }
+    return bestId;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "ecs/Entity.hpp"
+#include <cstdint>
+#include <vector>
+
+// Chỉ mục không gian dựng 1 lần mỗi tick (lưới đều + counting sort thành mảng liền),
+// dùng chung cho AI thủ môn / tranh bóng. Truy vấn lọc bằng Filter: cờ nhóm gán cho từng thực thể
+// lúc build và/hoặc đúng một id -> không giới hạn số thực thể hay giá trị id.
+// Vị trí là ảnh chụp lúc build: hệ thống nào đã di chuyển thực thể trong tick thì truyền slack
+// (quãng tối đa đi được từ lúc build) để lấy ứng viên, rồi tự kiểm tra lại bằng vị trí thật.
+class SpatialIndex {
+public:
+    // Cờ nhóm (build không truyền cờ thì mọi thực thể mang đủ mọi cờ)
+    enum Group : uint32_t { GroupBall = 1u << 0, GroupPlayer = 1u << 1 };
+
+    struct Item {
+        float x, y, r;
+        int   id;
+        uint32_t flags;
+        Entity* e;
+    };
+
+    // Nhận thực thể có (flags & item.flags) != 0, và nếu id >= 0 thì phải đúng id đó
+    struct Filter {
+        uint32_t flags;
+        int      id;
+        Filter() : flags(~0u), id(-1) {}   // ctor thay cho NSDMI: Filter{} làm tham số mặc định ngay trong lớp
+        bool pass(const Item& it) const { return (it.flags & flags) != 0 && (id < 0 || it.id == id); }
+    };
+    static Filter any()                 { return Filter{}; }
+    static Filter group(uint32_t flags) { Filter f; f.flags = flags; return f; }
+    static Filter only(int id)          { Filter f; f.id = id; return f; }
+
+    void init(float fieldW, float fieldH, float cellSize);
+    // flags: cờ nhóm song song với bodies (nullptr = ~0u cho tất cả)
+    void build(Entity* const* bodies, int n, const uint32_t* flags = nullptr);
+
+    int size() const { return (int)items.size(); }
+    float maxBodyRadius() const { return maxRadius; }
+    const Item* find(int id) const;
+
+    // n thực thể gần p nhất (tâm-tâm), tăng dần theo khoảng cách; trả về số id ghi vào out
+    int nearest(const Vec2& p, int n, int* out, Filter f = Filter{}) const;
+    // mọi thực thể có tâm cách p <= radius: gọi fn(const Item&) cho từng cái (không giới hạn số lượng)
+    template <class Fn> void forEachWithin(const Vec2& p, float radius, Filter f, Fn&& fn) const;
+    // như trên nhưng ghi tối đa cap kết quả (id, hoặc con trỏ Item để lấy thẳng Entity)
+    int withinRadius(const Vec2& p, float radius, int* out, int cap, Filter f = Filter{}) const;
+    int withinRadius(const Vec2& p, float radius, const Item** out, int cap, Filter f = Filter{}) const;
+    // trong nón: |d| <= range và góc với dir (đã chuẩn hóa) <= acos(cosHalf)
+    int withinCone(const Vec2& origin, const Vec2& dir, float cosHalf, float range,
+                   int* out, int cap, Filter f = Filter{}) const;
+    // Thực thể đầu tiên (gần a nhất) che đoạn a->b: khoảng cách tới đoạn <= r + margin và
+    // hình chiếu nằm trong (tMin, tMax). -1 nếu không bị che. (Tổng quát hóa KeeperSystem::occludedBy)
+    int segmentBlocker(const Vec2& a, const Vec2& b, float margin, Filter f = Filter{},
+                       float tMin = 0.05f, float tMax = 0.95f) const;
+
+private:
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+    float cell = 128.f, invCell = 1.f / 128.f;
+    float originX = 0.f, originY = 0.f;
+    int   cols = 1, rows = 1;
+    float maxRadius = 0.f;
+
+    std::vector<Item>     items;       // sắp theo ô
+    std::vector<uint32_t> cellStart;   // cols*rows + 1
+    std::vector<uint32_t> cellOf;      // ô của từng thực thể (tạm khi build)
+    std::vector<uint32_t> cursor;      // vị trí ghi kế tiếp của từng ô (tạm khi build)
+};
+
+template <class Fn>
+void SpatialIndex::forEachWithin(const Vec2& p, float radius, Filter f, Fn&& fn) const {
+    int x0 = cellX(p.x - radius), x1 = cellX(p.x + radius);
+    int y0 = cellY(p.y - radius), y1 = cellY(p.y + radius);
+    float r2 = radius * radius;
+    for (int cy = y0; cy <= y1; ++cy)
+        for (int cx = x0; cx <= x1; ++cx) {
+            int c = cy * cols + cx;
+            for (uint32_t k = cellStart[c]; k < cellStart[c + 1]; ++k) {
+                const Item& it = items[k];
+                if (!f.pass(it)) continue;
+                float dx = it.x - p.x, dy = it.y - p.y;
+                if (dx * dx + dy * dy <= r2) fn(it);
+            }
+        }
+}
@@ -0,0 +1,138 @@
+#include "scene/systems/WindField.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define TFA_WIND_SSE 1
+#endif
+
+static const float PI = 3.14159265358979323846f;
+
+void WindField::init(float fieldW, float fieldH, float cellPx, Pcg32& rng){
+    cell    = std::max(8.0f, cellPx);
+    invCell = 1.0f / cell;
+    nx = std::max(1, (int)std::ceil(fieldW * invCell));
+    ny = std::max(1, (int)std::ceil(fieldH * invCell));
+    // kẹp tọa độ ô để (ix+1, iy+1) luôn hợp lệ
+    maxFx = (float)nx - 1e-3f;
+    maxFy = (float)ny - 1e-3f;
+    gx.assign((size_t)(nx+1)*(ny+1), 0.f);
+    gy.assign((size_t)(nx+1)*(ny+1), 0.f);
+
+    for (Vec2& n : noise) {
+        float ang = rng.range(0.f, 2.f*PI);
+        float mag = rng.nextFloat();
+        n = Vec2(detCos(ang), detSin(ang)) * mag;
+    }
+    offset = Vec2(0,0);
+}
+
+void WindField::saveState(Checkpoint::WindState& out) const {
+    static_assert(Checkpoint::NOISE_CELLS == NOISE_N * NOISE_N, "Checkpoint::NOISE_CELLS phải bằng NOISE_N * NOISE_N");
+    out.drift = offset;
+    for (int i = 0; i < NOISE_N * NOISE_N; ++i) out.noise[i] = noise[i];
+}
+
+void WindField::loadState(const Checkpoint::WindState& in) {
+    offset = in.drift;
+    for (int i = 0; i < NOISE_N * NOISE_N; ++i) noise[i] = in.noise[i];
+}
+
+Vec2 WindField::noiseAt(float u, float v) const {
+    float fu = std::floor(u), fv = std::floor(v);
+    float tu = u - fu, tv = v - fv;
+    int iu = ((int)fu % NOISE_N + NOISE_N) % NOISE_N;
+    int iv = ((int)fv % NOISE_N + NOISE_N) % NOISE_N;
+    int iu1 = (iu + 1) % NOISE_N, iv1 = (iv + 1) % NOISE_N;
+    // smoothstep cho chuyển tiếp mềm giữa các ô nhiễu
+    tu = tu*tu*(3.f - 2.f*tu); tv = tv*tv*(3.f - 2.f*tv);
+    const Vec2& a = noise[iv *NOISE_N + iu], & b = noise[iv *NOISE_N + iu1];
+    const Vec2& c = noise[iv1*NOISE_N + iu], & d = noise[iv1*NOISE_N + iu1];
+    Vec2 top = a + (b - a) * tu;
+    Vec2 bot = c + (d - c) * tu;
+    return top + (bot - top) * tv;
+}
+
+void WindField::update(const Vec2& baseWind, float turbulence, float advectSpeed, float dt){
+    float strength = baseWind.length();
+    if (strength > 1e-4f) offset += baseWind * (advectSpeed * invCell * dt / strength);
+
+    float amp = turbulence * strength;
+    for (int iy = 0; iy <= ny; ++iy) {
+        for (int ix = 0; ix <= nx; ++ix) {
+            // nhiễu thô hơn lưới gió một nửa để xoáy lớn, mượt
+            Vec2 n = noiseAt(ix*0.5f - offset.x*0.5f, iy*0.5f - offset.y*0.5f);
+            int k = iy*(nx+1) + ix;
+            gx[k] = baseWind.x + n.x * amp;
+            gy[k] = baseWind.y + n.y * amp;
+        }
+    }
+}
+
+Vec2 WindField::sample(const Vec2& p) const {
+    if (gx.empty()) return Vec2(0,0);
+    float fx = std::min(std::max(p.x * invCell, 0.f), maxFx);
+    float fy = std::min(std::max(p.y * invCell, 0.f), maxFy);
+    int ix = (int)fx, iy = (int)fy;
+    float tx = fx - ix, ty = fy - iy;
+    int k = iy*(nx+1) + ix, s = nx + 1;
+    float x0 = gx[k]   + (gx[k+1]   - gx[k])   * tx;
+    float x1 = gx[k+s] + (gx[k+s+1] - gx[k+s]) * tx;
+    float y0 = gy[k]   + (gy[k+1]   - gy[k])   * tx;
+    float y1 = gy[k+s] + (gy[k+s+1] - gy[k+s]) * tx;
+    return Vec2(x0 + (x1 - x0) * ty, y0 + (y1 - y0) * ty);
+}
+
+void WindField::sample(const Vec2* pos, Vec2* out, int n, float scale) const {
+    if (gx.empty()) { for (int i = 0; i < n; ++i) out[i] = Vec2(0,0); return; }
+    int i = 0;
+#if TFA_WIND_SSE
+    const __m128 vInv  = _mm_set1_ps(invCell);
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vMaxX = _mm_set1_ps(maxFx), vMaxY = _mm_set1_ps(maxFy);
+    const __m128 vScl  = _mm_set1_ps(scale);
+    const __m128i vStride = _mm_set1_epi32(nx + 1);
+    const int s = nx + 1;
+    alignas(16) int idx[4];
+    for (; i + 4 <= n; i += 4) {
+        // AoS (x0,y0,x1,y1),(x2,y2,x3,y3) -> xs, ys
+        __m128 a  = _mm_loadu_ps(&pos[i].x);
+        __m128 b  = _mm_loadu_ps(&pos[i+2].x);
+        __m128 xs = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 ys = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+        __m128 fx = _mm_min_ps(_mm_max_ps(_mm_mul_ps(xs, vInv), vZero), vMaxX);
+        __m128 fy = _mm_min_ps(_mm_max_ps(_mm_mul_ps(ys, vInv), vZero), vMaxY);
+        __m128i ix = _mm_cvttps_epi32(fx), iy = _mm_cvttps_epi32(fy);
+        __m128 tx = _mm_sub_ps(fx, _mm_cvtepi32_ps(ix));
+        __m128 ty = _mm_sub_ps(fy, _mm_cvtepi32_ps(iy));
+
+        // k = iy*(nx+1) + ix  (SSE2 không có mullo_epi32 -> nhân qua float, chính xác với lưới nhỏ)
+        __m128i k = _mm_add_epi32(_mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(iy), _mm_cvtepi32_ps(vStride))), ix);
+        _mm_store_si128((__m128i*)idx, k);
+
+        // gom 4 góc cho 4 điểm (SSE không có gather)
+        __m128 x00 = _mm_set_ps(gx[idx[3]],     gx[idx[2]],     gx[idx[1]],     gx[idx[0]]);
+        __m128 x10 = _mm_set_ps(gx[idx[3]+1],   gx[idx[2]+1],   gx[idx[1]+1],   gx[idx[0]+1]);
+        __m128 x01 = _mm_set_ps(gx[idx[3]+s],   gx[idx[2]+s],   gx[idx[1]+s],   gx[idx[0]+s]);
+        __m128 x11 = _mm_set_ps(gx[idx[3]+s+1], gx[idx[2]+s+1], gx[idx[1]+s+1], gx[idx[0]+s+1]);
+        __m128 y00 = _mm_set_ps(gy[idx[3]],     gy[idx[2]],     gy[idx[1]],     gy[idx[0]]);
+        __m128 y10 = _mm_set_ps(gy[idx[3]+1],   gy[idx[2]+1],   gy[idx[1]+1],   gy[idx[0]+1]);
+        __m128 y01 = _mm_set_ps(gy[idx[3]+s],   gy[idx[2]+s],   gy[idx[1]+s],   gy[idx[0]+s]);
+        __m128 y11 = _mm_set_ps(gy[idx[3]+s+1], gy[idx[2]+s+1], gy[idx[1]+s+1], gy[idx[0]+s+1]);
+
+        __m128 wx0 = _mm_add_ps(x00, _mm_mul_ps(_mm_sub_ps(x10, x00), tx));
+        __m128 wx1 = _mm_add_ps(x01, _mm_mul_ps(_mm_sub_ps(x11, x01), tx));
+        __m128 wy0 = _mm_add_ps(y00, _mm_mul_ps(_mm_sub_ps(y10, y00), tx));
+        __m128 wy1 = _mm_add_ps(y01, _mm_mul_ps(_mm_sub_ps(y11, y01), tx));
+        __m128 wx  = _mm_mul_ps(_mm_add_ps(wx0, _mm_mul_ps(_mm_sub_ps(wx1, wx0), ty)), vScl);
+        __m128 wy  = _mm_mul_ps(_mm_add_ps(wy0, _mm_mul_ps(_mm_sub_ps(wy1, wy0), ty)), vScl);
+
+        // SoA -> AoS
+        _mm_storeu_ps(&out[i].x,   _mm_unpacklo_ps(wx, wy));
+        _mm_storeu_ps(&out[i+2].x, _mm_unpackhi_ps(wx, wy));
+    }
+#endif
+    for (; i < n; ++i) out[i] = sample(pos[i]) * scale;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "util/Math.hpp"
+#include "util/Rng.hpp"
+#include "core/Checkpoint.hpp"
+#include <vector>
+
+// Trường gió 2D thô phủ lên sân: gió nền + nhiễu được "thổi" (advect) theo hướng gió.
+// Lưới nút (nx+1)*(ny+1) lưu SoA; lấy mẫu song tuyến (bilinear) theo lô bằng SSE.
+class WindField {
+public:
+    // Dựng lưới cho sân fieldW x fieldH, mỗi ô cellPx; nhiễu gốc rút từ stream WindField
+    void init(float fieldW, float fieldH, float cellPx, Pcg32& rng);
+
+    // Cập nhật giá trị nút: gió nền + turbulence*|gió nền| * nhiễu(p - offset),
+    // offset trôi theo hướng gió với tốc độ advectSpeed (px/s)
+    void update(const Vec2& baseWind, float turbulence, float advectSpeed, float dt);
+
+    // out[i] = gió tại pos[i] * scale
+    void sample(const Vec2* pos, Vec2* out, int n, float scale) const;
+    Vec2 sample(const Vec2& pos) const;
+
+    int cols() const { return nx; }
+    int rows() const { return ny; }
+    Vec2 node(int ix, int iy) const { int k = iy*(nx+1) + ix; return Vec2(gx[k], gy[k]); }
+    float cellSize() const { return cell; }
+    Vec2  drift() const { return offset; }   // độ trôi nhiễu (băm trạng thái)
+
+    // Nhiễu gốc + độ trôi <-> checkpoint (giá trị nút được update() dựng lại trước khi lấy mẫu)
+    void saveState(Checkpoint::WindState& out) const;
+    void loadState(const Checkpoint::WindState& in);
+
+private:
+    static const int NOISE_N = 16;   // lưới nhiễu tuần hoàn NOISE_N x NOISE_N
+
+    int   nx = 0, ny = 0;
+    float cell = 1.0f, invCell = 1.0f;
+    float maxFx = 0.f, maxFy = 0.f;
+    std::vector<float> gx, gy;       // giá trị gió tại nút (px/s^2)
+
+    Vec2  noise[NOISE_N * NOISE_N];  // vector ngẫu nhiên độ dài <= 1
+    Vec2  offset;                    // độ trôi của nhiễu (đơn vị ô)
+
+    Vec2 noiseAt(float u, float v) const;
+};
@@ -0,0 +1,47 @@
+#include "sys/Camera.hpp"
+#include <algorithm>
+#include <cmath>
+
+void Camera::init(float fieldW_, float fieldH_, float viewW_, float viewH_, const Params& p) {
+    fieldW = fieldW_; fieldH = fieldH_;
+    viewW = std::max(1.0f, std::min(viewW_, fieldW));
+    viewH = std::max(1.0f, std::min(viewH_, fieldH));
+    P = p;
+    P.deadzoneRatio = std::min(std::max(P.deadzoneRatio, 0.0f), 1.0f);
+    P.lerp = std::min(std::max(P.lerp, 0.0f), 1.0f);
+    snap(Vec2(fieldW * 0.5f, fieldH * 0.5f));
+}
+
+void Camera::clampCenter() {
+    center.x = std::min(std::max(center.x, viewW * 0.5f), fieldW - viewW * 0.5f);
+    center.y = std::min(std::max(center.y, viewH * 0.5f), fieldH - viewH * 0.5f);
+}
+
+void Camera::snap(const Vec2& target) {
+    center = target;
+    clampCenter();
+}
+
+void Camera::follow(const Vec2& target, float dt) {
+    if (wholeField()) return;
+
+    // Tâm mong muốn: dời vừa đủ để mục tiêu quay về mép vùng chết
+    float hx = viewW * P.deadzoneRatio * 0.5f, hy = viewH * P.deadzoneRatio * 0.5f;
+    Vec2 want = center;
+    if      (target.x > center.x + hx) want.x = target.x - hx;
+    else if (target.x < center.x - hx) want.x = target.x + hx;
+    if      (target.y > center.y + hy) want.y = target.y - hy;
+    else if (target.y < center.y - hy) want.y = target.y + hy;
+
+    // lerp tính cho frame 60 Hz -> quy ra dt bất kỳ
+    float k = (P.lerp >= 1.0f) ? 1.0f : 1.0f - std::pow(1.0f - P.lerp, dt * 60.0f);
+    center += (want - center) * k;
+    clampCenter();
+}
+
+void Camera::setScreen(int sw, int sh) {
+    sx = (float)sw / viewW;
+    sy = (float)sh / viewH;
+    offX = std::round(left() * sx);
+    offY = std::round(top() * sy);
+}
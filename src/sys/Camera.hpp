@@ -0,0 +1,54 @@
+#pragma once
+#include <SDL.h>
+#include "util/Math.hpp"
+
+// Camera 2D bám theo mục tiêu (bóng) trên sân có thể lớn hơn cửa sổ.
+// Vùng nhìn viewW x viewH (đơn vị thế giới = px sân): nhỏ hơn sân thì cuộn, không thì đứng yên cả trục đó.
+// Mục tiêu còn trong vùng chết (deadzone, tỉ lệ vùng nhìn quanh tâm) thì không cuộn; ra ngoài thì tâm
+// trượt tới vị trí giữ mục tiêu ở mép vùng chết, theo lerp (phần đi được mỗi frame 60 Hz, độc lập FPS).
+class Camera {
+public:
+    struct Params {
+        float deadzoneRatio = 0.3f;
+        float lerp = 0.1f;
+    };
+
+    void init(float fieldW, float fieldH, float viewW, float viewH, const Params& p);
+
+    void snap(const Vec2& target);                // nhảy thẳng tới (kickoff, nạp checkpoint)
+    void follow(const Vec2& target, float dt);
+
+    // Tỉ lệ thế giới -> màn hình sw x sh (gọi đầu mỗi frame render)
+    void setScreen(int sw, int sh);
+    float scaleX() const { return sx; }
+    float scaleY() const { return sy; }
+
+    // Cả sân nằm trong vùng nhìn -> camera đứng yên, nền tĩnh cache theo màn hình dùng lại được
+    bool wholeField() const { return viewW >= fieldW && viewH >= fieldH; }
+
+    // Vùng nhìn trong tọa độ thế giới
+    float left() const   { return center.x - viewW * 0.5f; }
+    float top() const    { return center.y - viewH * 0.5f; }
+    float width() const  { return viewW; }
+    float height() const { return viewH; }
+
+    // Hình tròn tâm (cx, cy) bán kính r (đã cộng lề vẽ) có chạm vùng nhìn không
+    bool visible(float cx, float cy, float r) const {
+        return cx + r >= left() && cx - r <= left() + viewW && cy + r >= top() && cy - r <= top() + viewH;
+    }
+
+    SDL_FPoint toScreen(float x, float y) const { return SDL_FPoint{ x * sx - offX, y * sy - offY }; }
+    SDL_FRect  rectFor(float cx, float cy, float r) const {
+        return SDL_FRect{ (cx - r) * sx - offX, (cy - r) * sy - offY, (r * 2) * sx, (r * 2) * sy };
+    }
+
+private:
+    float fieldW = 0.f, fieldH = 0.f;
+    float viewW = 1.f, viewH = 1.f;
+    Params P;
+    Vec2  center;
+    float sx = 1.f, sy = 1.f;
+    float offX = 0.f, offY = 0.f;   // góc trên-trái vùng nhìn theo pixel màn hình (làm tròn: không rung)
+
+    void clampCenter();
+};
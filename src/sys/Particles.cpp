@@ -0,0 +1,235 @@
+#include "sys/Particles.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define TFA_VEC_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define TFA_VEC_SSE 1
+#endif
+
+static const float PI = 3.14159265358979323846f;
+
+static inline uint32_t packRGBA(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    SDL_Color c{ r, g, b, a };
+    uint32_t u; std::memcpy(&u, &c, sizeof u);
+    return u;
+}
+
+void ParticleSystem::init(SDL_Renderer* renderer, const Params& p) {
+    close();
+    P = p;
+    cap = std::max(0, P.capacity);
+    for (std::vector<float>* a : { &px, &py, &vx, &vy, &life, &invLife, &drag, &size }) a->assign((size_t)cap, 0.0f);
+    color.assign((size_t)cap, 0u);
+    kind.assign((size_t)cap, 0);
+    vtx.resize((size_t)cap * 4);
+    idx.resize((size_t)cap * 6);
+    for (int q = 0; q < cap; ++q) {
+        int b = q * 4, *o = &idx[(size_t)q * 6];
+        o[0] = b; o[1] = b + 1; o[2] = b + 2; o[3] = b; o[4] = b + 2; o[5] = b + 3;
+    }
+
+    //                 life        speed         spread  inherit drag  size        layer
+    defs[Trail]    = { 0.25f, 0.40f,  0.f,  15.f, PI,    0.05f, 3.0f, 2.5f, 3.5f, RenderQueue::LayerParticles, 0 };
+    defs[Turf]     = { 0.40f, 0.80f, 60.f, 200.f, 0.7f,  0.0f,  5.0f, 1.5f, 3.0f, RenderQueue::LayerParticles, 0 };
+    defs[Confetti] = { 1.50f, 3.00f, 80.f, 320.f, PI,    0.0f,  1.6f, 2.0f, 3.5f, RenderQueue::LayerConfetti,  0 };
+
+    // Chấm tròn mềm 16x16 (alpha giảm dần ra mép) cho vệt + cỏ; pháo giấy là quad màu đặc
+    if (renderer) {
+        const int D = 16;
+        uint32_t pix[D * D];
+        for (int y = 0; y < D; ++y)
+            for (int x = 0; x < D; ++x) {
+                float dx = (x + 0.5f) / D * 2.f - 1.f, dy = (y + 0.5f) / D * 2.f - 1.f;
+                float a = std::max(0.0f, 1.0f - std::sqrt(dx * dx + dy * dy));
+                pix[y * D + x] = packRGBA(255, 255, 255, (uint8_t)(255.f * std::min(1.0f, a * 1.6f)));
+            }
+        dotTex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, D, D);
+        if (dotTex) {
+            SDL_UpdateTexture(dotTex, nullptr, pix, D * 4);
+            SDL_SetTextureBlendMode(dotTex, SDL_BLENDMODE_BLEND);
+        }
+    }
+
+    // Gom loại cùng (layer, texture) thành 1 nhóm vẽ
+    groupCount = 0;
+    for (int k = 0; k < KindCount; ++k) {
+        SDL_Texture* tex = (k == Confetti) ? nullptr : dotTex;
+        int g = 0;
+        while (g < groupCount && !(groupTex[g] == tex && groupLayer[g] == defs[k].layer)) ++g;
+        if (g == groupCount) { groupTex[g] = tex; groupLayer[g] = defs[k].layer; ++groupCount; }
+        defs[k].group = (uint8_t)g;
+    }
+    clear();
+}
+
+void ParticleSystem::close() {
+    if (dotTex) { SDL_DestroyTexture(dotTex); dotTex = nullptr; }
+    cap = 0; n = 0;
+}
+
+void ParticleSystem::clear() {
+    n = 0;
+    trailCarry = 0.0f;
+    for (int& c : kindAlive) c = 0;
+}
+
+void ParticleSystem::spawn(Kind k, const Vec2& pos, const Vec2& v, float lifeSec, float radius, uint32_t rgba) {
+    if (n >= cap) return;
+    int i = n++;
+    px[i] = pos.x; py[i] = pos.y; vx[i] = v.x; vy[i] = v.y;
+    life[i] = lifeSec; invLife[i] = 1.0f / lifeSec;
+    drag[i] = defs[k].drag; size[i] = radius;
+    color[i] = rgba; kind[i] = k;
+    ++kindAlive[k];
+}
+
+void ParticleSystem::kill(int i) {
+    --kindAlive[kind[i]];
+    int last = --n;
+    if (i == last) return;
+    px[i] = px[last]; py[i] = py[last]; vx[i] = vx[last]; vy[i] = vy[last];
+    life[i] = life[last]; invLife[i] = invLife[last]; drag[i] = drag[last]; size[i] = size[last];
+    color[i] = color[last]; kind[i] = kind[last];
+}
+
+void ParticleSystem::emit(Kind k, const Vec2& pos, const Vec2& vel, int count) {
+    static const uint32_t turf[3] = { packRGBA(70, 140, 50, 255), packRGBA(110, 90, 50, 255), packRGBA(90, 170, 70, 255) };
+    static const uint32_t confetti[6] = {
+        packRGBA(255, 80, 80, 255),  packRGBA(255, 220, 60, 255), packRGBA(80, 200, 255, 255),
+        packRGBA(120, 255, 120, 255), packRGBA(255, 255, 255, 255), packRGBA(230, 120, 255, 255) };
+
+    const KindDef& d = defs[k];
+    count = std::min(count, cap - n);
+    const float speed = vel.length();
+    const float base  = (speed > 1e-3f) ? std::atan2(vel.y, vel.x) : 0.0f;
+    const float spread = (speed > 1e-3f) ? d.spread : PI;
+    for (int c = 0; c < count; ++c) {
+        float a = base + rng.range(-spread, spread);
+        float s = rng.range(d.speedMin, d.speedMax);
+        Vec2 v = Vec2(std::cos(a), std::sin(a)) * s + vel * d.inherit;
+        uint32_t rgba = (k == Trail) ? packRGBA(255, 255, 255, 150)
+                      : (k == Turf)  ? turf[rng.nextU32() % 3]
+                                     : confetti[rng.nextU32() % 6];
+        spawn(k, pos, v, rng.range(d.lifeMin, d.lifeMax), rng.range(d.sizeMin, d.sizeMax), rgba);
+    }
+}
+
+void ParticleSystem::onEvent(const MatchEvent& e) {
+    if (cap == 0) return;
+    switch (e.type) {
+    case MatchEvent::Shot:   emit(Turf, e.pos, e.vel, 10); break;
+    case MatchEvent::Tackle: emit(Turf, e.pos, e.vel, 28); break;
+    case MatchEvent::Goal:   emit(Confetti, e.pos, Vec2(0.f, 0.f), P.goalConfetti); break;
+    default: break;
+    }
+}
+
+void ParticleSystem::trail(const Vec2& pos, const Vec2& vel, float dt) {
+    const float speed = vel.length();
+    if (cap == 0 || speed < P.trailSpeed) { trailCarry = 0.0f; return; }
+    // 1 hạt mỗi 3 px bóng đi, rải đều trên đoạn vừa bay qua
+    const float spacing = 3.0f;
+    float dist = speed * dt + trailCarry;
+    int count = (int)(dist / spacing);
+    trailCarry = dist - count * spacing;
+    for (int c = 0; c < count; ++c) {
+        float back = (c + 0.5f) / (float)std::max(count, 1);
+        emit(Trail, pos - vel * (dt * back), vel, 1);
+    }
+}
+
+void ParticleSystem::update(float dt) {
+    if (n == 0) return;
+    int i = 0;
+    int firstDead = n;   // chỉ quét dọn từ hạt chết đầu tiên (phần lớn frame không có hạt nào chết)
+#if TFA_VEC_AVX
+    {
+        const __m256 vdt = _mm256_set1_ps(dt), one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps();
+        for (; i + 8 <= n; i += 8) {
+            __m256 f = _mm256_max_ps(zero, _mm256_sub_ps(one, _mm256_mul_ps(_mm256_loadu_ps(&drag[i]), vdt)));
+            __m256 x = _mm256_mul_ps(_mm256_loadu_ps(&vx[i]), f);
+            __m256 y = _mm256_mul_ps(_mm256_loadu_ps(&vy[i]), f);
+            _mm256_storeu_ps(&vx[i], x);
+            _mm256_storeu_ps(&vy[i], y);
+            _mm256_storeu_ps(&px[i], _mm256_add_ps(_mm256_loadu_ps(&px[i]), _mm256_mul_ps(x, vdt)));
+            _mm256_storeu_ps(&py[i], _mm256_add_ps(_mm256_loadu_ps(&py[i]), _mm256_mul_ps(y, vdt)));
+            __m256 l = _mm256_sub_ps(_mm256_loadu_ps(&life[i]), vdt);
+            _mm256_storeu_ps(&life[i], l);
+            if (firstDead == n && _mm256_movemask_ps(_mm256_cmp_ps(l, zero, _CMP_LE_OQ))) firstDead = i;
+        }
+    }
+#endif
+#if TFA_VEC_SSE
+    {
+        const __m128 vdt = _mm_set1_ps(dt), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+        for (; i + 4 <= n; i += 4) {
+            __m128 f = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(_mm_loadu_ps(&drag[i]), vdt)));
+            __m128 x = _mm_mul_ps(_mm_loadu_ps(&vx[i]), f);
+            __m128 y = _mm_mul_ps(_mm_loadu_ps(&vy[i]), f);
+            _mm_storeu_ps(&vx[i], x);
+            _mm_storeu_ps(&vy[i], y);
+            _mm_storeu_ps(&px[i], _mm_add_ps(_mm_loadu_ps(&px[i]), _mm_mul_ps(x, vdt)));
+            _mm_storeu_ps(&py[i], _mm_add_ps(_mm_loadu_ps(&py[i]), _mm_mul_ps(y, vdt)));
+            __m128 l = _mm_sub_ps(_mm_loadu_ps(&life[i]), vdt);
+            _mm_storeu_ps(&life[i], l);
+            if (firstDead == n && _mm_movemask_ps(_mm_cmple_ps(l, zero))) firstDead = i;
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        float f = std::max(0.0f, 1.0f - drag[i] * dt);
+        vx[i] *= f; vy[i] *= f;
+        px[i] += vx[i] * dt; py[i] += vy[i] * dt;
+        life[i] -= dt;
+        if (firstDead == n && life[i] <= 0.0f) firstDead = i;
+    }
+
+    // Dọn hạt chết: lấy hạt cuối lấp chỗ (không giữ thứ tự, mảng luôn đặc)
+    for (int j = firstDead; j < n; ) {
+        if (life[j] <= 0.0f) kill(j);
+        else ++j;
+    }
+}
+
+void ParticleSystem::queue(RenderQueue& q, const Camera& cam) {
+    if (n == 0) return;
+
+    // Mỗi nhóm một vùng đỉnh liền nhau, đủ chỗ cho mọi hạt còn sống của nhóm
+    int start[KindCount] = {}, cursor[KindCount] = {};
+    for (int g = 0, off = 0; g < groupCount; ++g) {
+        start[g] = cursor[g] = off;
+        for (int k = 0; k < KindCount; ++k) if (defs[k].group == g) off += kindAlive[k];
+    }
+
+    const float l = cam.left(), t = cam.top(), r = l + cam.width(), b = t + cam.height();
+    const float sx = cam.scaleX(), sy = cam.scaleY();
+    const SDL_FPoint uv0{0.f, 0.f}, uv1{1.f, 0.f}, uv2{1.f, 1.f}, uv3{0.f, 1.f};
+    for (int i = 0; i < n; ++i) {
+        const float s = size[i];
+        if (px[i] + s < l || px[i] - s > r || py[i] + s < t || py[i] - s > b) continue;
+
+        SDL_FPoint c = cam.toScreen(px[i], py[i]);
+        const float hw = s * sx, hh = s * sy;
+        SDL_Color col; std::memcpy(&col, &color[i], sizeof col);
+        // mờ dần trong nửa cuối đời
+        col.a = (uint8_t)(col.a * std::min(1.0f, life[i] * invLife[i] * 2.0f));
+
+        SDL_Vertex* v = &vtx[(size_t)cursor[defs[kind[i]].group]++ * 4];
+        v[0] = SDL_Vertex{ SDL_FPoint{c.x - hw, c.y - hh}, col, uv0 };
+        v[1] = SDL_Vertex{ SDL_FPoint{c.x + hw, c.y - hh}, col, uv1 };
+        v[2] = SDL_Vertex{ SDL_FPoint{c.x + hw, c.y + hh}, col, uv2 };
+        v[3] = SDL_Vertex{ SDL_FPoint{c.x - hw, c.y + hh}, col, uv3 };
+    }
+
+    for (int g = 0; g < groupCount; ++g) {
+        int count = cursor[g] - start[g];
+        if (count == 0) continue;
+        q.batch(groupLayer[g], groupTex[g], &vtx[(size_t)start[g] * 4], count * 4, idx.data(), count * 6);
+    }
+}
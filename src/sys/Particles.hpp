@@ -0,0 +1,90 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include <cstdint>
+#include "util/Math.hpp"
+#include "util/Rng.hpp"
+#include "sys/Camera.hpp"
+#include "sys/RenderQueue.hpp"
+#include "scene/systems/MatchEvents.hpp"
+
+// Hiệu ứng hạt (chỉ để nhìn, không thuộc trạng thái mô phỏng: không băm, không checkpoint).
+// Pool SoA dung lượng cố định cấp phát 1 lần ở init: mỗi thuộc tính một mảng float liền nhau
+// để update chạy SIMD (SSE/AVX như util/MathBatch); hạt chết bị thay bằng hạt cuối (mảng luôn đặc).
+// Hết chỗ thì bỏ hạt mới. Vẽ: các loại hạt cùng (layer, texture) dùng chung 1 vùng đỉnh
+// -> mỗi nhóm đúng 1 lần SDL_RenderGeometry qua RenderQueue::batch.
+class ParticleSystem {
+public:
+    enum Kind : uint8_t {
+        Trail = 0,      // vệt sau bóng bay nhanh
+        Turf,           // cỏ văng khi xoạc / sút
+        Confetti,       // pháo giấy khi có bàn thắng
+        KindCount
+    };
+
+    struct Params {
+        int   capacity = 65536;      // 0 = tắt
+        float trailSpeed = 480.0f;   // bóng nhanh hơn (px/s) mới có vệt
+        int   goalConfetti = 1500;
+    };
+
+    ParticleSystem() = default;
+    ~ParticleSystem() { close(); }
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    // Cấp phát pool + dựng texture chấm mềm cho Trail/Turf (renderer null: mọi loại vẽ quad màu đặc)
+    void init(SDL_Renderer* renderer, const Params& p);
+    void close();
+    void clear();
+
+    // Phát count hạt loại k quanh pos; hướng/tốc độ ban đầu lấy theo vel (0 = tỏa đều)
+    void emit(Kind k, const Vec2& pos, const Vec2& vel, int count);
+    // Kích hoạt theo sự kiện của tick (sút, xoạc, bàn thắng)
+    void onEvent(const MatchEvent& e);
+    // Vệt bóng: phát theo quãng đường bóng đi khi đủ nhanh
+    void trail(const Vec2& pos, const Vec2& vel, float dt);
+
+    void update(float dt);
+
+    // Dựng đỉnh cho hạt trong vùng nhìn rồi ghi các lô vào queue (buffer giữ tới lần queue sau)
+    void queue(RenderQueue& q, const Camera& cam);
+
+    int alive() const    { return n; }
+    int capacity() const { return cap; }
+
+private:
+    struct KindDef {
+        float lifeMin, lifeMax;
+        float speedMin, speedMax;
+        float spread;            // nửa góc tỏa quanh hướng vel (rad); >= PI = mọi hướng
+        float inherit;           // phần vận tốc vel truyền cho hạt
+        float drag;              // cản tuyến tính (1/s)
+        float sizeMin, sizeMax;  // bán kính (px sân)
+        uint8_t layer;
+        uint8_t group;           // cùng (layer, texture) -> chung lô vẽ
+    };
+
+    Params P;
+    int cap = 0, n = 0;
+
+    // SoA, mỗi mảng cap phần tử; [0, n) là hạt sống
+    std::vector<float> px, py, vx, vy, life, invLife, drag, size;
+    std::vector<uint32_t> color;     // RGBA theo thứ tự byte của SDL_Color
+    std::vector<uint8_t>  kind;
+
+    KindDef defs[KindCount];
+    int     kindAlive[KindCount] = {};
+    SDL_Texture* groupTex[KindCount] = {};
+    uint8_t groupLayer[KindCount] = {};
+    int     groupCount = 0;
+
+    std::vector<SDL_Vertex> vtx;     // 4 đỉnh / hạt, dùng lại giữa các frame
+    std::vector<int>        idx;     // 6 chỉ số / hạt, dựng sẵn 1 lần cho cả pool
+    SDL_Texture* dotTex = nullptr;
+    float trailCarry = 0.0f;         // quãng đường dư chưa đủ 1 hạt vệt
+    Pcg32 rng{0x9e3779b97f4a7c15ULL, 0x50415254ULL};   // stream riêng: không đụng MatchRng
+
+    void spawn(Kind k, const Vec2& pos, const Vec2& v, float lifeSec, float radius, uint32_t rgba);
+    void kill(int i);
+};
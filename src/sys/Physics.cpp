@@ -1,182 +1,364 @@
 #include "ecs/Player.hpp"
 #include "sys/Physics.hpp"
-#include <SDL_mixer.h>
+#include "sys/VoiceManager.hpp"
+#include "util/MathBatch.hpp"
 #include <cmath>
 #include <algorithm>
 
+static inline float invMassOf(const Entity* e){ return e->mass > 0.0f ? 1.0f / e->mass : 0.0f; }
+
 void PhysicsSystem::step(float dt, std::vector<Entity*>& entities, Goals& goals, int fieldWidth, int fieldHeight) {
-    // Tích hợp vị trí cho tất cả thực thể dựa trên vận tốc hiện tại
+    if (P.fixedPoint) stepFixed(dt, entities, goals, fieldWidth, fieldHeight);
+    else              stepFloat(dt, entities, goals, fieldWidth, fieldHeight);
+}
+
+void PhysicsSystem::stepFloat(float dt, std::vector<Entity*>& entities, Goals& goals, int fieldWidth, int fieldHeight) {
+    int sub = std::max(1, P.substeps);
+    float h = dt / sub;
+    collectActive(entities);
+    for (int s = 0; s < sub; ++s) {
+        // Ma sát cho bóng theo lô (các cầu thủ đã áp dụng khi applyInput: k = 0 -> nhân đúng 1.0)
+        int na = (int)active.size();
+        intVel.resize(na); intDrag.resize(na);
+        for (int i = 0; i < na; ++i) {
+            intVel[i]  = active[i]->tf.vel;
+            intDrag[i] = active[i]->mass < 1.0f ? active[i]->drag : 0.0f;   // giả định mass <1 nghĩa là bóng
+        }
+        VecBatch::damp(intVel.data(), intDrag.data(), na, h);
+        // Tích hợp vị trí cho các thực thể đang thức dựa trên vận tốc hiện tại
+        for (int i = 0; i < na; ++i) {
+            Entity* ent = active[i];
+            ent->tf.vel = intVel[i];
+            ent->tf.pos.x += ent->tf.vel.x * h;
+            ent->tf.pos.y += ent->tf.vel.y * h;
+        }
+        // Va chạm tròn-tròn: giải lặp trên vận tốc rồi sửa xuyên trên vị trí
+        findContacts(entities);
+        if (P.warmStart) warmStart();
+        solveVelocities();
+        solvePositions();
+        storeImpulses();
+
+        // Va chạm với tường (các cạnh sân) và cột gôn
+        for (Entity* ent : active) collideBounds(ent, goals, fieldWidth, fieldHeight);
+    }
+    updateSleep(dt);
+}
+
+PhysicsSystem::Body& PhysicsSystem::body(const Entity* e) {
+    if (e->id >= (int)bodies.size()) bodies.resize(e->id + 1);
+    return bodies[e->id];
+}
+
+void PhysicsSystem::packState(StateHash::Packer& pk) const {
+    for (const Body& b : bodies) { pk.put(b.asleep); pk.put(b.idle); }
+    for (const Cached& k : cache) { pk.put(k.key); pk.put(k.n); pk.put(k.jn); pk.put(k.jvRaw); }
+}
+
+void PhysicsSystem::saveState(Checkpoint::PhysicsState& out) const {
+    out.bodyCount = (int32_t)std::min(bodies.size(), (size_t)Checkpoint::MAX_BODIES);
+    for (int i = 0; i < out.bodyCount; ++i) {
+        const Body& b = bodies[i];
+        out.bodies[i] = { b.idle, b.restPos, (uint8_t)b.asleep, {0, 0, 0} };
+    }
+    out.contactCount = (int32_t)std::min(cache.size(), (size_t)Checkpoint::MAX_CONTACTS);
+    for (int i = 0; i < out.contactCount; ++i) {
+        const Cached& k = cache[i];
+        out.contacts[i] = { k.key, k.n, k.jn, k.jvRaw };
+    }
+}
+
+void PhysicsSystem::loadState(const Checkpoint::PhysicsState& in) {
+    int nb = std::max(0, std::min((int)in.bodyCount, Checkpoint::MAX_BODIES));
+    int nc = std::max(0, std::min((int)in.contactCount, Checkpoint::MAX_CONTACTS));
+    bodies.assign(nb, Body{});
+    for (int i = 0; i < nb; ++i) {
+        bodies[i].idle = in.bodies[i].idle;
+        bodies[i].asleep = in.bodies[i].asleep != 0;
+        bodies[i].restPos = in.bodies[i].restPos;
+    }
+    cache.resize(nc);
+    for (int i = 0; i < nc; ++i) {
+        const Checkpoint::ContactState& k = in.contacts[i];
+        cache[i] = { k.key, k.n, k.jn, k.jvRaw };
+    }
+}
+
+bool PhysicsSystem::isAsleep(const Entity* e) const {
+    return e->id < (int)bodies.size() && bodies[e->id].asleep;
+}
+
+void PhysicsSystem::wake(Entity* e) {
+    Body& b = body(e);
+    b.idle = 0.f;
+    if (!b.asleep) return;
+    b.asleep = false;
+    active.push_back(e);
+}
+
+void PhysicsSystem::collectActive(std::vector<Entity*>& entities) {
+    active.clear();
     for (Entity* ent : entities) {
-        // Áp dụng ma sát cho bóng (các cầu thủ đã áp dụng khi applyInput)
-        if (ent->mass < 1.0f) { // giả định mass <1 nghĩa là bóng
-            ent->tf.vel.x *= std::exp(-ent->drag * dt);
-            ent->tf.vel.y *= std::exp(-ent->drag * dt);
+        Body& b = body(ent);
+        if (!P.sleep) { b.asleep = false; active.push_back(ent); continue; }
+        // đánh thức khi logic game đổi vận tốc (input, sút, gió...) hoặc dời chỗ (kickoff, dắt bóng)
+        if (b.asleep && (ent->tf.vel.length2() > P.sleepSpeed * P.sleepSpeed ||
+                         ent->tf.pos.x != b.restPos.x || ent->tf.pos.y != b.restPos.y)) {
+            b.asleep = false; b.idle = 0.f;
         }
-        ent->tf.pos.x += ent->tf.vel.x * dt;
-        ent->tf.pos.y += ent->tf.vel.y * dt;
+        if (!b.asleep) active.push_back(ent);
+    }
+}
+
+int PhysicsSystem::findRoot(int i) {
+    while (island[i] != i) { island[i] = island[island[i]]; i = island[i]; }
+    return i;
+}
+
+void PhysicsSystem::updateSleep(float dt) {
+    lastAwake = (int)active.size();
+    if (!P.sleep) return;
+
+    // gom đảo theo các tiếp xúc của bước con cuối
+    size_t n = active.size();
+    island.resize(n);
+    for (size_t i = 0; i < n; ++i) island[i] = (int)i;
+    for (size_t i = 0; i < n; ++i) body(active[i]).slot = (int)i;
+    for (const auto& t : touching) {
+        int ra = findRoot(body(t.first).slot), rb = findRoot(body(t.second).slot);
+        if (ra != rb) island[ra] = rb;
+    }
+
+    // đảo ngủ khi mọi thành viên đã đứng yên đủ sleepTime
+    std::vector<float> minIdle(n, 1e30f);
+    for (size_t i = 0; i < n; ++i) {
+        Entity* e = active[i];
+        Body& b = body(e);
+        b.idle = (e->tf.vel.length2() < P.sleepSpeed * P.sleepSpeed) ? b.idle + dt : 0.f;
+        int r = findRoot((int)i);
+        minIdle[r] = std::min(minIdle[r], b.idle);
     }
-    // Xử lý va chạm tròn-tròn giữa các thực thể động
-    size_t n = entities.size();
     for (size_t i = 0; i < n; ++i) {
-        Entity* e1 = entities[i];
-        for (size_t j = i + 1; j < n; ++j) {
-            Entity* e2 = entities[j];
-            // Kiểm tra trùng lặp (không xét cặp GK cùng đội? – ở đây vẫn xét vì họ có thể va chạm)
-            float dx = e2->tf.pos.x - e1->tf.pos.x;
-            float dy = e2->tf.pos.y - e1->tf.pos.y;
+        if (minIdle[findRoot((int)i)] < P.sleepTime) continue;
+        Entity* e = active[i];
+        Body& b = body(e);
+        b.asleep = true;
+        e->tf.vel = Vec2(0, 0);
+        b.restPos = e->tf.pos;
+    }
+}
+
+void PhysicsSystem::findContacts(std::vector<Entity*>& entities) {
+    contacts.clear();
+    // chỉ duyệt cặp có ít nhất một vật thức: chi phí ~ (số vật thức) x (tổng số vật)
+    // (active có thể dài thêm khi đánh thức vật ngủ ngay trong vòng lặp)
+    for (size_t i = 0; i < active.size(); ++i) {
+        for (Entity* other : entities) {
+            Entity* self = active[i];
+            if (other == self) continue;
+            bool sleepOther = isAsleep(other);
+            if (!sleepOther && other->id < self->id) continue;   // cặp 2 vật thức: xét từ phía id nhỏ
+            // luôn để a là id nhỏ hơn -> kết quả không phụ thuộc thứ tự trong danh sách
+            Entity* a = self;
+            Entity* b = other;
+            if (b->id < a->id) std::swap(a, b);
+            uint32_t key = ((uint32_t)a->id << 16) | (uint32_t)b->id;
+            if (std::any_of(contacts.begin(), contacts.end(),
+                            [key](const Contact& c){ return c.key == key; })) continue;
+            float dx = b->tf.pos.x - a->tf.pos.x;
+            float dy = b->tf.pos.y - a->tf.pos.y;
             float dist2 = dx*dx + dy*dy;
-            float rsum = e1->radius + e2->radius;
-            if (dist2 < rsum * rsum && dist2 > 0.0f) {
-                float dist = std::sqrt(dist2);
-                // Vector pháp tuyến đơn vị từ e1 -> e2
-                float nx = dx / dist;
-                float ny = dy / dist;
-                // Vận tốc tương đối theo pháp tuyến
-                float relVx = e1->tf.vel.x - e2->tf.vel.x;
-                float relVy = e1->tf.vel.y - e2->tf.vel.y;
-                float relDotN = relVx * nx + relVy * ny;
-                // Nếu vận tốc hướng vào nhau (đang va chạm)
-                if (relDotN < 0) {
-                    // Hệ số đàn hồi e tùy cặp va chạm
-                    float elast;
-                    if (e1->mass < 1.0f || e2->mass < 1.0f) {
-                        // Nếu một trong hai là bóng
-                        elast = 0.3f;
-                    } else {
-                        // Cầu thủ vs cầu thủ
-                        elast = 0.2f;
-                    }
-                    // Tính xung (impulse) phản hồi va chạm
-                    float invMass1 = 1.0f / e1->mass;
-                    float invMass2 = 1.0f / e2->mass;
-                    float J = -(1.0f + elast) * relDotN / (invMass1 + invMass2);
-                    // Cập nhật vận tốc sau va chạm
-                    e1->tf.vel.x += J * nx * invMass1;
-                    e1->tf.vel.y += J * ny * invMass1;
-                    e2->tf.vel.x -= J * nx * invMass2;
-                    e2->tf.vel.y -= J * ny * invMass2;
-                }
-                // Xử lý tách xuyên (đẩy các thực thể ra khỏi nhau nếu overlap)
-                float overlap = rsum - dist;
-                // Tính phần dịch chuyển cho mỗi thực thể theo khối lượng (vật nhẹ di chuyển nhiều hơn)
-                float invMass1 = (e1->mass > 0 ? 1.0f / e1->mass : 0.0f);
-                float invMass2 = (e2->mass > 0 ? 1.0f / e2->mass : 0.0f);
-                float sumInvMass = invMass1 + invMass2;
-                if (sumInvMass == 0) sumInvMass = 1.0f;
-                float move1 = overlap * invMass1 / sumInvMass;
-                float move2 = overlap * invMass2 / sumInvMass;
-                // Dịch chuyển e1 ngược hướng pháp tuyến, e2 theo hướng pháp tuyến để tách chúng
-                e1->tf.pos.x -= move1 * nx;
-                e1->tf.pos.y -= move1 * ny;
-                e2->tf.pos.x += move2 * nx;
-                e2->tf.pos.y += move2 * ny;
-            }
+            float rsum = a->radius + b->radius;
+            if (dist2 >= rsum * rsum || dist2 <= 0.0f) continue;
+
+            // vật thức chạm vật ngủ -> đánh thức (cả đảo của nó sẽ thức theo dây chuyền)
+            if (sleepOther) wake(other);
+
+            float dist = std::sqrt(dist2);
+            Contact c;
+            c.a = a; c.b = b;
+            c.key = key;
+            c.n = Vec2(dx / dist, dy / dist);
+            float imSum = invMassOf(a) + invMassOf(b);
+            c.massN = (imSum > 0.0f) ? 1.0f / imSum : 0.0f;
+            // Hệ số đàn hồi e tùy cặp va chạm: có bóng 0.3, cầu thủ vs cầu thủ 0.2
+            float elast = (a->mass < 1.0f || b->mass < 1.0f) ? 0.3f : 0.2f;
+            float vn = Vec2::dot(b->tf.vel - a->tf.vel, c.n);   // < 0: đang lao vào nhau
+            c.bias = (vn < -P.bounceThreshold) ? -elast * vn : 0.0f;
+            c.jn = 0.0f;
+            contacts.push_back(c);
         }
     }
-    // Va chạm bóng với tường (các cạnh sân) và cột gôn
-    for (Entity* ent : entities) {
-        // Nếu ent là bóng
-        if (ent->mass < 1.0f) {
-            Ball* ball = static_cast<Ball*>(ent);
-            // Tường trên/dưới
-            if (ball->tf.pos.y - ball->radius < 0) {
-                ball->tf.pos.y = ball->radius;
-                ball->tf.vel.y = -ball->tf.vel.y * ball->e_wall;
-                Mix_Chunk* wallSfx = Mix_LoadWAV("assets/audio/wall.wav");
-                if (wallSfx) Mix_PlayChannel(-1, wallSfx, 0);
-            }
-            if (ball->tf.pos.y + ball->radius > fieldHeight) {
-                ball->tf.pos.y = fieldHeight - ball->radius;
-                ball->tf.vel.y = -ball->tf.vel.y * ball->e_wall;
-                Mix_Chunk* wallSfx = Mix_LoadWAV("assets/audio/wall.wav");
-                if (wallSfx) Mix_PlayChannel(-1, wallSfx, 0);
+    std::sort(contacts.begin(), contacts.end(),
+              [](const Contact& x, const Contact& y){ return x.key < y.key; });
+}
+
+void PhysicsSystem::warmStart() {
+    for (Contact& c : contacts) {
+        for (const Cached& k : cache) {
+            if (k.key != c.key) continue;
+            // pháp tuyến đổi nhiều thì bỏ xung cũ
+            if (Vec2::dot(k.n, c.n) > 0.9f) {
+                c.jn = k.jn;
+                Vec2 J = c.n * c.jn;
+                c.a->tf.vel -= J * invMassOf(c.a);
+                c.b->tf.vel += J * invMassOf(c.b);
             }
-            // Tường trái/phải (trừ khu vực khung thành)
-            if (ball->tf.pos.x - ball->radius < 0) {
-                // Nếu bóng không lọt vào giữa 2 cột (ngoài khu cầu môn)
-                if (!(ball->tf.pos.y > goals.goalY1 && ball->tf.pos.y < goals.goalY2)) {
-                    ball->tf.pos.x = ball->radius;
-                    ball->tf.vel.x = -ball->tf.vel.x * ball->e_wall;
-                    Mix_Chunk* wallSfx = Mix_LoadWAV("assets/audio/wall.wav");
-                    if (wallSfx) Mix_PlayChannel(-1, wallSfx, 0);
-                }
+            break;
+        }
+    }
+}
+
+void PhysicsSystem::solveVelocities() {
+    for (int it = 0; it < P.iterations; ++it) {
+        for (Contact& c : contacts) {
+            float vn = Vec2::dot(c.b->tf.vel - c.a->tf.vel, c.n);
+            float lambda = c.massN * (c.bias - vn);
+            // kẹp xung tích lũy >= 0 (chỉ đẩy, không kéo)
+            float jnNew = std::max(c.jn + lambda, 0.0f);
+            float dj = jnNew - c.jn;
+            c.jn = jnNew;
+            Vec2 J = c.n * dj;
+            c.a->tf.vel -= J * invMassOf(c.a);
+            c.b->tf.vel += J * invMassOf(c.b);
+        }
+    }
+}
+
+void PhysicsSystem::solvePositions() {
+    for (int it = 0; it < P.iterations; ++it) {
+        float worst = 0.0f;
+        for (Contact& c : contacts) {
+            float imA = invMassOf(c.a), imB = invMassOf(c.b);
+            float imSum = imA + imB;
+            if (imSum <= 0.0f) continue;
+            Vec2 d = c.b->tf.pos - c.a->tf.pos;
+            float dist = d.length();
+            float depth = c.a->radius + c.b->radius - dist;
+            worst = std::max(worst, depth);
+            if (depth <= P.slop) continue;
+            // vật nhẹ di chuyển nhiều hơn; sửa từng phần mỗi vòng để không giật
+            Vec2 n = (dist > 1e-6f) ? d * (1.0f / dist) : c.n;
+            float corr = std::min(P.baumgarte * (depth - P.slop), P.maxCorrection);
+            c.a->tf.pos -= n * (corr * imA / imSum);
+            c.b->tf.pos += n * (corr * imB / imSum);
+        }
+        if (worst <= P.slop) break;
+    }
+}
+
+void PhysicsSystem::storeImpulses() {
+    cache.clear(); touching.clear();
+    for (const Contact& c : contacts) {
+        cache.push_back({ c.key, c.n, c.jn, 0 });
+        touching.push_back({ c.a, c.b });
+    }
+}
+
+// To nhỏ theo tốc độ bóng sau va chạm; kênh/tần suất do VoiceManager quyết
+void PhysicsSystem::hitSfx(bool post, float x, float speed) {
+    if (!audio) return;
+    float gain = std::min(1.0f, std::max(0.25f, speed / 600.0f));
+    audio->play(post ? VoiceManager::Post : VoiceManager::Wall, x, gain);
+}
+
+void PhysicsSystem::collideBounds(Entity* ent, Goals& goals, int fieldWidth, int fieldHeight) {
+    // Nếu ent là bóng
+    if (ent->mass < 1.0f) {
+        Ball* ball = static_cast<Ball*>(ent);
+        // Tường trên/dưới
+        if (ball->tf.pos.y - ball->radius < 0) {
+            ball->tf.pos.y = ball->radius;
+            ball->tf.vel.y = -ball->tf.vel.y * ball->e_wall;
+            hitSfx(false, ball->tf.pos.x, ball->tf.vel.length());
+        }
+        if (ball->tf.pos.y + ball->radius > fieldHeight) {
+            ball->tf.pos.y = fieldHeight - ball->radius;
+            ball->tf.vel.y = -ball->tf.vel.y * ball->e_wall;
+            hitSfx(false, ball->tf.pos.x, ball->tf.vel.length());
+        }
+        // Tường trái/phải (trừ khu vực khung thành)
+        if (ball->tf.pos.x - ball->radius < 0) {
+            // Nếu bóng không lọt vào giữa 2 cột (ngoài khu cầu môn)
+            if (!(ball->tf.pos.y > goals.goalY1 && ball->tf.pos.y < goals.goalY2)) {
+                ball->tf.pos.x = ball->radius;
+                ball->tf.vel.x = -ball->tf.vel.x * ball->e_wall;
+                hitSfx(false, ball->tf.pos.x, ball->tf.vel.length());
             }
-            if (ball->tf.pos.x + ball->radius > fieldWidth) {
-                if (!(ball->tf.pos.y > goals.goalY1 && ball->tf.pos.y < goals.goalY2)) {
-                    ball->tf.pos.x = fieldWidth - ball->radius;
-                    ball->tf.vel.x = -ball->tf.vel.x * ball->e_wall;
-                    Mix_Chunk* wallSfx = Mix_LoadWAV("assets/audio/wall.wav");
-                    if (wallSfx) Mix_PlayChannel(-1, wallSfx, 0);
-                }
+        }
+        if (ball->tf.pos.x + ball->radius > fieldWidth) {
+            if (!(ball->tf.pos.y > goals.goalY1 && ball->tf.pos.y < goals.goalY2)) {
+                ball->tf.pos.x = fieldWidth - ball->radius;
+                ball->tf.vel.x = -ball->tf.vel.x * ball->e_wall;
+                hitSfx(false, ball->tf.pos.x, ball->tf.vel.length());
             }
-            // Va chạm bóng với cột gôn (trụ cầu môn)
-            Post posts[4] = { goals.leftPosts[0], goals.leftPosts[1], goals.rightPosts[0], goals.rightPosts[1] };
-            for (int p = 0; p < 4; ++p) {
-                float dx = ball->tf.pos.x - posts[p].pos.x;
-                float dy = ball->tf.pos.y - posts[p].pos.y;
-                float dist2 = dx*dx + dy*dy;
-                float sumRad = ball->radius + posts[p].radius;
-                if (dist2 < sumRad * sumRad && dist2 > 0.0f) {
-                    float dist = std::sqrt(dist2);
-                    float nx = dx / dist;
-                    float ny = dy / dist;
-                    // Đẩy bóng ra khỏi cột
-                    float overlap = sumRad - dist;
-                    ball->tf.pos.x += nx * overlap;
-                    ball->tf.pos.y += ny * overlap;
-                    // Phản xạ vận tốc bóng quanh pháp tuyến cột
-                    float vDotN = ball->tf.vel.x * nx + ball->tf.vel.y * ny;
-                    if (vDotN < 0) {
-                        ball->tf.vel.x -= (1.0f + ball->e_wall) * vDotN * nx;
-                        ball->tf.vel.y -= (1.0f + ball->e_wall) * vDotN * ny;
-                    }
-                    Mix_Chunk* postSfx = Mix_LoadWAV("assets/audio/post.wav");
-                    if (postSfx) Mix_PlayChannel(-1, postSfx, 0);
+        }
+        // Va chạm bóng với cột gôn (trụ cầu môn)
+        Post posts[4] = { goals.leftPosts[0], goals.leftPosts[1], goals.rightPosts[0], goals.rightPosts[1] };
+        for (int p = 0; p < 4; ++p) {
+            float dx = ball->tf.pos.x - posts[p].pos.x;
+            float dy = ball->tf.pos.y - posts[p].pos.y;
+            float dist2 = dx*dx + dy*dy;
+            float sumRad = ball->radius + posts[p].radius;
+            if (dist2 < sumRad * sumRad && dist2 > 0.0f) {
+                float dist = std::sqrt(dist2);
+                float nx = dx / dist;
+                float ny = dy / dist;
+                // Đẩy bóng ra khỏi cột
+                float overlap = sumRad - dist;
+                ball->tf.pos.x += nx * overlap;
+                ball->tf.pos.y += ny * overlap;
+                // Phản xạ vận tốc bóng quanh pháp tuyến cột
+                float vDotN = ball->tf.vel.x * nx + ball->tf.vel.y * ny;
+                if (vDotN < 0) {
+                    ball->tf.vel.x -= (1.0f + ball->e_wall) * vDotN * nx;
+                    ball->tf.vel.y -= (1.0f + ball->e_wall) * vDotN * ny;
                 }
+                hitSfx(true, ball->tf.pos.x, ball->tf.vel.length());
             }
-        } else {
-            // Nếu ent là cầu thủ (va chạm tường)
-            Player* player = dynamic_cast<Player*>(ent);
-            if (!player) continue;
-            // Tường trên/dưới
-            if (player->tf.pos.y - player->radius < 0) {
-                player->tf.pos.y = player->radius;
-                if (player->tf.vel.y < 0) player->tf.vel.y = 0;
-            }
-            if (player->tf.pos.y + player->radius > fieldHeight) {
-                player->tf.pos.y = fieldHeight - player->radius;
-                if (player->tf.vel.y > 0) player->tf.vel.y = 0;
-            }
-            // Tường trái/phải (kể cả vùng cầu môn để không lọt ra ngoài)
-            if (player->tf.pos.x - player->radius < 0) {
-                player->tf.pos.x = player->radius;
-                if (player->tf.vel.x < 0) player->tf.vel.x = 0;
-            }
-            if (player->tf.pos.x + player->radius > fieldWidth) {
-                player->tf.pos.x = fieldWidth - player->radius;
-                if (player->tf.vel.x > 0) player->tf.vel.x = 0;
-            }
-            // Va chạm cầu thủ với cột gôn (tránh kẹt vào cột)
-            Post posts[4] = { goals.leftPosts[0], goals.leftPosts[1], goals.rightPosts[0], goals.rightPosts[1] };
-            for (int p = 0; p < 4; ++p) {
-                float dx = player->tf.pos.x - posts[p].pos.x;
-                float dy = player->tf.pos.y - posts[p].pos.y;
-                float dist2 = dx*dx + dy*dy;
-                float sumRad = player->radius + posts[p].radius;
-                if (dist2 < sumRad * sumRad && dist2 > 0.0f) {
-                    float dist = std::sqrt(dist2);
-                    float nx = dx / dist;
-                    float ny = dy / dist;
-                    // Đẩy cầu thủ ra khỏi cột
-                    float overlap = sumRad - dist;
-                    player->tf.pos.x += nx * overlap;
-                    player->tf.pos.y += ny * overlap;
-                    // Giảm vận tốc hướng vào cột (không nẩy lại để tránh rung)
-                    float vDotN = player->tf.vel.x * nx + player->tf.vel.y * ny;
-                    if (vDotN < 0) {
-                        player->tf.vel.x -= vDotN * nx;
-                        player->tf.vel.y -= vDotN * ny;
-                    }
+        }
+    } else {
+        // Nếu ent là cầu thủ (va chạm tường)
+        Player* player = dynamic_cast<Player*>(ent);
+        if (!player) return;
+        // Tường trên/dưới
+        if (player->tf.pos.y - player->radius < 0) {
+            player->tf.pos.y = player->radius;
+            if (player->tf.vel.y < 0) player->tf.vel.y = 0;
+        }
+        if (player->tf.pos.y + player->radius > fieldHeight) {
+            player->tf.pos.y = fieldHeight - player->radius;
+            if (player->tf.vel.y > 0) player->tf.vel.y = 0;
+        }
+        // Tường trái/phải (kể cả vùng cầu môn để không lọt ra ngoài)
+        if (player->tf.pos.x - player->radius < 0) {
+            player->tf.pos.x = player->radius;
+            if (player->tf.vel.x < 0) player->tf.vel.x = 0;
+        }
+        if (player->tf.pos.x + player->radius > fieldWidth) {
+            player->tf.pos.x = fieldWidth - player->radius;
+            if (player->tf.vel.x > 0) player->tf.vel.x = 0;
+        }
+        // Va chạm cầu thủ với cột gôn (tránh kẹt vào cột)
+        Post posts[4] = { goals.leftPosts[0], goals.leftPosts[1], goals.rightPosts[0], goals.rightPosts[1] };
+        for (int p = 0; p < 4; ++p) {
+            float dx = player->tf.pos.x - posts[p].pos.x;
+            float dy = player->tf.pos.y - posts[p].pos.y;
+            float dist2 = dx*dx + dy*dy;
+            float sumRad = player->radius + posts[p].radius;
+            if (dist2 < sumRad * sumRad && dist2 > 0.0f) {
+                float dist = std::sqrt(dist2);
+                float nx = dx / dist;
+                float ny = dy / dist;
+                // Đẩy cầu thủ ra khỏi cột
+                float overlap = sumRad - dist;
+                player->tf.pos.x += nx * overlap;
+                player->tf.pos.y += ny * overlap;
+                // Giảm vận tốc hướng vào cột (không nẩy lại để tránh rung)
+                float vDotN = player->tf.vel.x * nx + player->tf.vel.y * ny;
+                if (vDotN < 0) {
+                    player->tf.vel.x -= vDotN * nx;
+                    player->tf.vel.y -= vDotN * ny;
                 }
             }
         }
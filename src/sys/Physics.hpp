@@ -1,11 +1,119 @@
 #pragma once
 #include <vector>
+#include <cstdint>
+#include <utility>
 #include "ecs/Entity.hpp"
 #include "ecs/Goal.hpp"
+#include "util/Fixed.hpp"
+#include "core/StateHash.hpp"
+#include "core/Checkpoint.hpp"
+
+class VoiceManager;
 
 // Hệ thống vật lý: xử lý tích hợp chuyển động và va chạm giữa các thực thể
 class PhysicsSystem {
 public:
-    // Hàm cập nhật vật lý cho danh sách thực thể trong dt thời gian
+    // Bộ giải tiếp xúc lặp (sequential impulses) + chia nhỏ bước
+    struct Params {
+        int   substeps   = 2;       // số bước con mỗi tick
+        int   iterations = 6;       // số vòng giải vận tốc / vị trí mỗi bước con
+        bool  warmStart  = true;    // khởi động từ xung tích lũy của tick trước
+        float baumgarte  = 0.3f;    // tỉ lệ sửa xuyên mỗi vòng giải vị trí
+        float slop       = 0.5f;    // px xuyên cho phép (tránh rung)
+        float maxCorrection = 6.0f; // px tối đa đẩy ra mỗi vòng
+        float bounceThreshold = 30.0f; // px/s: chậm hơn thì không nảy (e = 0)
+
+        // Ngủ: cả "đảo" tiếp xúc đứng yên đủ lâu thì bỏ qua hoàn toàn cho tới khi bị đánh thức
+        bool  sleep      = true;
+        float sleepSpeed = 4.0f;    // px/s: chậm hơn coi như đứng yên
+        float sleepTime  = 0.5f;    // s đứng yên trước khi ngủ
+
+        // Nhánh Q16.16 tất định (mặc định bật khi build với TFA_FIXED_POINT)
+        bool  fixedPoint = (TFA_FIXED_POINT != 0);
+    };
+
+    PhysicsSystem() : P{} {}
+    explicit PhysicsSystem(const Params& p) : P(p) {}
+
+    void setParams(const Params& p) { P = p; }
+    const Params& params() const { return P; }
+    void reset() { cache.clear(); bodies.clear(); }
+
+    // Tiếng bóng chạm tường / cột (null = im lặng, vd. benchmark, nhánh rẽ checkpoint)
+    void setAudio(VoiceManager* a) { audio = a; }
+
+    bool isAsleep(const Entity* e) const;
+    int  awakeCount() const { return lastAwake; }   // số thực thể được mô phỏng ở tick vừa rồi
+
+    // Trạng thái ẩn ảnh hưởng tick sau (ngủ, xung warm start) vào khối băm
+    void packState(StateHash::Packer& pk) const;
+    // Cùng trạng thái đó <-> checkpoint (phần vượt sức chứa cố định bị bỏ, chỉ mất warm start)
+    void saveState(Checkpoint::PhysicsState& out) const;
+    void loadState(const Checkpoint::PhysicsState& in);
+
+    // Hàm cập nhật vật lý cho danh sách thực thể trong dt thời gian (chọn nhánh theo P.fixedPoint)
     void step(float dt, std::vector<Entity*>& entities, Goals& goals, int fieldWidth, int fieldHeight);
+    void stepFloat(float dt, std::vector<Entity*>& entities, Goals& goals, int fieldWidth, int fieldHeight);
+    // Cùng thuật toán trên Q16.16: trạng thái float chỉ đổi ở đầu/cuối tick (sys/PhysicsFixed.cpp)
+    void stepFixed(float dt, std::vector<Entity*>& entities, Goals& goals, int fieldWidth, int fieldHeight);
+
+private:
+    // Tiếp xúc tròn-tròn trong một bước con; key = (id nhỏ << 16) | id lớn
+    struct Contact {
+        Entity* a; Entity* b;
+        uint32_t key;
+        Vec2  n;          // pháp tuyến đơn vị a -> b
+        float massN;      // 1 / (invMassA + invMassB)
+        float bias;       // vận tốc tách mục tiêu (đàn hồi)
+        float jn;         // xung pháp tuyến tích lũy (>= 0)
+    };
+    // Xung của tick trước để warm start (giữ theo cặp id, không theo thứ tự danh sách)
+    // (nhánh Q16.16 giữ xung theo đơn vị vận tốc ở jvRaw)
+    struct Cached { uint32_t key; Vec2 n; float jn; int32_t jvRaw; };
+
+    // Tiếp xúc của nhánh Q16.16: xung tích lũy tính theo đơn vị vận tốc (jv = jn / massN)
+    // để không tràn Q16.16 với khối lượng cầu thủ; wA/wB = invMass / tổng invMass
+    struct FxContact {
+        Entity* a; Entity* b;
+        int sa, sb;       // chỉ số trong active / fxPos / fxVel
+        uint32_t key;
+        FxVec2 n;
+        Fixed wA, wB, bias, jv;
+    };
+
+    // Trạng thái ngủ theo id thực thể
+    struct Body { float idle = 0.f; bool asleep = false; Vec2 restPos; int slot = 0; };
+
+    Params P;
+    VoiceManager* audio = nullptr;
+    std::vector<Contact> contacts;
+    std::vector<Cached>  cache;
+    std::vector<Body>    bodies;
+    std::vector<Entity*> active;    // thực thể thức trong tick hiện tại
+    std::vector<int>     island;    // union-find theo chỉ số trong active
+    std::vector<std::pair<Entity*, Entity*>> touching;   // cặp chạm nhau ở bước con cuối
+    std::vector<FxContact> fxContacts;
+    std::vector<FxVec2>    fxPos, fxVel;   // trạng thái Q16.16, song song với active
+    std::vector<Vec2>      intVel;         // vận tốc gom liền nhau cho VecBatch::damp, song song với active
+    std::vector<float>     intDrag;
+    int lastAwake = 0;
+
+    Body& body(const Entity* e);
+    void wake(Entity* e);
+    void collectActive(std::vector<Entity*>& entities);
+    void updateSleep(float dt);
+    int  findRoot(int i);
+
+    void findContacts(std::vector<Entity*>& entities);   // cần collectActive trước
+    void warmStart();
+    void solveVelocities();
+    void solvePositions();
+    void storeImpulses();
+    void collideBounds(Entity* ent, Goals& goals, int fieldWidth, int fieldHeight);
+    void hitSfx(bool post, float x, float speed);
+
+    void   loadFx(Entity* e);
+    FxVec2 fxPosOf(const Entity* e);
+    void   findContactsFixed(std::vector<Entity*>& entities);
+    void   collideBoundsFixed(int slot, const Goals& goals, int fieldWidth, int fieldHeight);
 };
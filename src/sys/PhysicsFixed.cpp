@@ -0,0 +1,206 @@
+#include "ecs/Player.hpp"
+#include "sys/Physics.hpp"
+#include <algorithm>
+
+// Nhánh Q16.16 của PhysicsSystem: cùng thứ tự thao tác với stepFloat nhưng chỉ dùng số nguyên,
+// nên cùng input thì cho kết quả từng bit như nhau trên mọi compiler x86-64.
+// Các hệ số lấy từ float (khối lượng, drag, Params) chỉ qua phép + - * / IEEE rồi đổi sang Q16.16.
+
+static inline FxVec2 scaleQ32(const FxVec2& v, int64_t hQ32) {
+    const int64_t HALF = (int64_t)1 << 31;
+    return FxVec2(Fixed::fromRaw((int32_t)(((int64_t)v.x.raw * hQ32 + HALF) >> 32)),
+                  Fixed::fromRaw((int32_t)(((int64_t)v.y.raw * hQ32 + HALF) >> 32)));
+}
+
+static inline int64_t squareWide(Fixed a) { return (int64_t)a.raw * a.raw; }
+
+void PhysicsSystem::loadFx(Entity* e) {
+    body(e).slot = (int)fxPos.size();
+    fxPos.push_back(FxVec2::from(e->tf.pos));
+    fxVel.push_back(FxVec2::from(e->tf.vel));
+}
+
+FxVec2 PhysicsSystem::fxPosOf(const Entity* e) {
+    return isAsleep(e) ? FxVec2::from(e->tf.pos) : fxPos[body(e).slot];
+}
+
+void PhysicsSystem::stepFixed(float dt, std::vector<Entity*>& entities, Goals& goals, int fieldWidth, int fieldHeight) {
+    int sub = std::max(1, P.substeps);
+    float h = dt / sub;
+    const int64_t hQ32 = std::llrint((double)h * 4294967296.0);   // bước con ở Q0.32 (h < 1s)
+
+    collectActive(entities);
+    fxPos.clear(); fxVel.clear();
+    for (Entity* e : active) loadFx(e);
+
+    const Fixed baum = Fixed::fromFloat(P.baumgarte), slop = Fixed::fromFloat(P.slop);
+    const Fixed maxCorr = Fixed::fromFloat(P.maxCorrection);
+    const Fixed warmCos = Fixed::fromFloat(0.9f);
+
+    for (int s = 0; s < sub; ++s) {
+        // Tích hợp (bóng chịu ma sát e^{-drag*h})
+        for (size_t i = 0; i < active.size(); ++i) {
+            Entity* e = active[i];
+            if (e->mass < 1.0f) fxVel[i] = fxVel[i] * fx::exp(Fixed::fromFloat(-e->drag * h));
+            fxPos[i] += scaleQ32(fxVel[i], hQ32);
+        }
+
+        findContactsFixed(entities);
+
+        if (P.warmStart) {
+            for (FxContact& c : fxContacts) {
+                for (const Cached& k : cache) {
+                    if (k.key != c.key) continue;
+                    if (FxVec2::dot(FxVec2::from(k.n), c.n) > warmCos) {
+                        c.jv = Fixed::fromRaw(k.jvRaw);
+                        fxVel[c.sa] -= c.n * (c.jv * c.wA);
+                        fxVel[c.sb] += c.n * (c.jv * c.wB);
+                    }
+                    break;
+                }
+            }
+        }
+
+        // Giải vận tốc: xung tích lũy >= 0
+        for (int it = 0; it < P.iterations; ++it) {
+            for (FxContact& c : fxContacts) {
+                Fixed vn = FxVec2::dot(fxVel[c.sb] - fxVel[c.sa], c.n);
+                Fixed jNew = fx::max(c.jv + (c.bias - vn), Fixed{});
+                Fixed dj = jNew - c.jv;
+                c.jv = jNew;
+                fxVel[c.sa] -= c.n * (dj * c.wA);
+                fxVel[c.sb] += c.n * (dj * c.wB);
+            }
+        }
+
+        // Sửa xuyên từng phần trên vị trí
+        for (int it = 0; it < P.iterations; ++it) {
+            Fixed worst{};
+            for (FxContact& c : fxContacts) {
+                FxVec2 d = fxPos[c.sb] - fxPos[c.sa];
+                Fixed dist = d.length();
+                Fixed depth = Fixed::fromFloat(c.a->radius + c.b->radius) - dist;
+                worst = fx::max(worst, depth);
+                if (depth <= slop) continue;
+                FxVec2 n = (dist.raw > 0) ? FxVec2(d.x / dist, d.y / dist) : c.n;
+                Fixed corr = fx::min(baum * (depth - slop), maxCorr);
+                fxPos[c.sa] -= n * (corr * c.wA);
+                fxPos[c.sb] += n * (corr * c.wB);
+            }
+            if (worst <= slop) break;
+        }
+
+        cache.clear(); touching.clear();
+        for (const FxContact& c : fxContacts) {
+            cache.push_back({ c.key, c.n.to<Vec2>(), 0.0f, c.jv.raw });
+            touching.push_back({ c.a, c.b });
+        }
+
+        for (size_t i = 0; i < active.size(); ++i) collideBoundsFixed((int)i, goals, fieldWidth, fieldHeight);
+    }
+
+    for (size_t i = 0; i < active.size(); ++i) {
+        active[i]->tf.pos = fxPos[i].to<Vec2>();
+        active[i]->tf.vel = fxVel[i].to<Vec2>();
+    }
+    updateSleep(dt);
+}
+
+void PhysicsSystem::findContactsFixed(std::vector<Entity*>& entities) {
+    fxContacts.clear();
+    const Fixed bounceThr = Fixed::fromFloat(P.bounceThreshold);
+    for (size_t i = 0; i < active.size(); ++i) {
+        for (Entity* other : entities) {
+            Entity* self = active[i];
+            if (other == self) continue;
+            bool sleepOther = isAsleep(other);
+            if (!sleepOther && other->id < self->id) continue;
+            Entity* a = self;
+            Entity* b = other;
+            if (b->id < a->id) std::swap(a, b);
+            uint32_t key = ((uint32_t)a->id << 16) | (uint32_t)b->id;
+            if (std::any_of(fxContacts.begin(), fxContacts.end(),
+                            [key](const FxContact& c){ return c.key == key; })) continue;
+
+            FxVec2 d = fxPosOf(b) - fxPosOf(a);
+            int64_t d2 = d.length2Wide();
+            if (d2 <= 0 || d2 >= squareWide(Fixed::fromFloat(a->radius + b->radius))) continue;
+            Fixed dist = d.length();
+            if (dist.raw <= 0) continue;
+
+            if (sleepOther) { wake(other); loadFx(other); }
+
+            FxContact c;
+            c.a = a; c.b = b; c.key = key;
+            c.sa = body(a).slot; c.sb = body(b).slot;
+            c.n = FxVec2(d.x / dist, d.y / dist);
+            float imA = (a->mass > 0.0f) ? 1.0f / a->mass : 0.0f;
+            float imB = (b->mass > 0.0f) ? 1.0f / b->mass : 0.0f;
+            float imSum = imA + imB;
+            c.wA = (imSum > 0.0f) ? Fixed::fromFloat(imA / imSum) : Fixed{};
+            c.wB = (imSum > 0.0f) ? Fixed::fromFloat(imB / imSum) : Fixed{};
+            // đàn hồi: có bóng 0.3, cầu thủ vs cầu thủ 0.2
+            Fixed elast = Fixed::fromFloat((a->mass < 1.0f || b->mass < 1.0f) ? 0.3f : 0.2f);
+            Fixed vn = FxVec2::dot(fxVel[c.sb] - fxVel[c.sa], c.n);
+            c.bias = (vn < -bounceThr) ? -(elast * vn) : Fixed{};
+            c.jv = Fixed{};
+            fxContacts.push_back(c);
+        }
+    }
+    std::sort(fxContacts.begin(), fxContacts.end(),
+              [](const FxContact& x, const FxContact& y){ return x.key < y.key; });
+}
+
+void PhysicsSystem::collideBoundsFixed(int slot, const Goals& goals, int fieldWidth, int fieldHeight) {
+    Entity* ent = active[slot];
+    FxVec2& p = fxPos[slot];
+    FxVec2& v = fxVel[slot];
+    const Fixed zero{};
+    const Fixed r = Fixed::fromFloat(ent->radius);
+    const Fixed W = Fixed::fromInt(fieldWidth), H = Fixed::fromInt(fieldHeight);
+    const Post posts[4] = { goals.leftPosts[0], goals.leftPosts[1], goals.rightPosts[0], goals.rightPosts[1] };
+
+    if (ent->mass < 1.0f) {
+        // Bóng: nảy tường (trừ miệng khung thành) và cột gôn
+        const Fixed e = Fixed::fromFloat(ent->e_wall);
+        const Fixed gy1 = Fixed::fromFloat(goals.goalY1), gy2 = Fixed::fromFloat(goals.goalY2);
+        if (p.y - r < zero) { p.y = r;     v.y = -(v.y * e); hitSfx(false, p.x.toFloat(), v.length().toFloat()); }
+        if (p.y + r > H)    { p.y = H - r; v.y = -(v.y * e); hitSfx(false, p.x.toFloat(), v.length().toFloat()); }
+        bool inMouth = (p.y > gy1 && p.y < gy2);
+        if (p.x - r < zero && !inMouth) { p.x = r;     v.x = -(v.x * e); hitSfx(false, p.x.toFloat(), v.length().toFloat()); }
+        if (p.x + r > W    && !inMouth) { p.x = W - r; v.x = -(v.x * e); hitSfx(false, p.x.toFloat(), v.length().toFloat()); }
+        for (const Post& post : posts) {
+            FxVec2 d = p - FxVec2::from(post.pos);
+            Fixed sumRad = Fixed::fromFloat(ent->radius + post.radius);
+            int64_t d2 = d.length2Wide();
+            if (d2 <= 0 || d2 >= squareWide(sumRad)) continue;
+            Fixed dist = d.length();
+            if (dist.raw <= 0) continue;
+            FxVec2 n(d.x / dist, d.y / dist);
+            p += n * (sumRad - dist);
+            Fixed vDotN = FxVec2::dot(v, n);
+            if (vDotN < zero) v -= n * ((Fixed::fromInt(1) + e) * vDotN);
+            hitSfx(true, p.x.toFloat(), v.length().toFloat());
+        }
+        return;
+    }
+
+    if (!dynamic_cast<Player*>(ent)) return;
+    // Cầu thủ: kẹp trong sân, triệt vận tốc hướng ra tường / vào cột (không nảy)
+    if (p.y - r < zero) { p.y = r;     if (v.y < zero) v.y = zero; }
+    if (p.y + r > H)    { p.y = H - r; if (v.y > zero) v.y = zero; }
+    if (p.x - r < zero) { p.x = r;     if (v.x < zero) v.x = zero; }
+    if (p.x + r > W)    { p.x = W - r; if (v.x > zero) v.x = zero; }
+    for (const Post& post : posts) {
+        FxVec2 d = p - FxVec2::from(post.pos);
+        Fixed sumRad = Fixed::fromFloat(ent->radius + post.radius);
+        int64_t d2 = d.length2Wide();
+        if (d2 <= 0 || d2 >= squareWide(sumRad)) continue;
+        Fixed dist = d.length();
+        if (dist.raw <= 0) continue;
+        FxVec2 n(d.x / dist, d.y / dist);
+        p += n * (sumRad - dist);
+        Fixed vDotN = FxVec2::dot(v, n);
+        if (vDotN < zero) v -= n * vDotN;
+    }
+}
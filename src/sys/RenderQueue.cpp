@@ -0,0 +1,146 @@
+#include "sys/RenderQueue.hpp"
+#include <algorithm>
+
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+    #error "RenderQueue cần SDL >= 2.0.18 (SDL_RenderGeometry)"
+#endif
+
+void RenderQueue::clear() {
+    cmds.clear();
+    batches.clear();
+}
+
+void RenderQueue::registerTexture(SDL_Texture* tex) {
+    if (tex && texKeys.emplace(tex, nextTexKey).second) ++nextTexKey;
+}
+
+void RenderQueue::unregisterTexture(SDL_Texture* tex) {
+    texKeys.erase(tex);
+}
+
+void RenderQueue::push(const Cmd& c) {
+    cmds.push_back(c);
+    Cmd& b = cmds.back();
+    b.seq = (uint32_t)(cmds.size() - 1);
+    if (!b.tex) b.texKey = 0;
+    else { auto it = texKeys.find(b.tex); b.texKey = (it != texKeys.end()) ? it->second : UNREGISTERED; }
+}
+
+void RenderQueue::sprite(uint8_t layer, SDL_Texture* tex, const SDL_FRect& d, SDL_Color tint) {
+    spriteRegion(layer, tex, d, SDL_FRect{0.f, 0.f, 1.f, 1.f}, tint);
+}
+
+void RenderQueue::spriteRegion(uint8_t layer, SDL_Texture* tex, const SDL_FRect& d, const SDL_FRect& uv,
+                               SDL_Color tint) {
+    if (!tex) return;
+    Cmd c{};
+    c.layer = layer; c.kind = Geometry; c.verts = 4; c.tex = tex; c.color = tint;
+    c.p[0] = {d.x,       d.y};       c.uv[0] = {uv.x,        uv.y};
+    c.p[1] = {d.x + d.w, d.y};       c.uv[1] = {uv.x + uv.w, uv.y};
+    c.p[2] = {d.x + d.w, d.y + d.h}; c.uv[2] = {uv.x + uv.w, uv.y + uv.h};
+    c.p[3] = {d.x,       d.y + d.h}; c.uv[3] = {uv.x,        uv.y + uv.h};
+    push(c);
+}
+
+void RenderQueue::triangle(uint8_t layer, SDL_FPoint a, SDL_FPoint b, SDL_FPoint cc, SDL_Color color) {
+    Cmd c{};
+    c.layer = layer; c.kind = Geometry; c.verts = 3; c.tex = nullptr; c.color = color;
+    c.p[0] = a; c.p[1] = b; c.p[2] = cc;
+    push(c);
+}
+
+void RenderQueue::rect(uint8_t layer, const SDL_FRect& d, SDL_Color color) {
+    Cmd c{};
+    c.layer = layer; c.kind = Geometry; c.verts = 4; c.tex = nullptr; c.color = color;
+    c.p[0] = {d.x,       d.y};
+    c.p[1] = {d.x + d.w, d.y};
+    c.p[2] = {d.x + d.w, d.y + d.h};
+    c.p[3] = {d.x,       d.y + d.h};
+    push(c);
+}
+
+void RenderQueue::line(uint8_t layer, float x1, float y1, float x2, float y2, SDL_Color color) {
+    Cmd c{};
+    c.layer = layer; c.kind = Line; c.verts = 2; c.tex = nullptr; c.color = color;
+    c.p[0] = {x1, y1}; c.p[1] = {x2, y2};
+    push(c);
+}
+
+void RenderQueue::batch(uint8_t layer, SDL_Texture* tex, const SDL_Vertex* v, int nv, const int* ix, int ni) {
+    if (nv <= 0 || ni <= 0) return;
+    batches.push_back(Batch{ layer, tex, v, ix, nv, ni });
+}
+
+static inline uint32_t packColor(SDL_Color c) {
+    return ((uint32_t)c.r << 24) | ((uint32_t)c.g << 16) | ((uint32_t)c.b << 8) | c.a;
+}
+
+void RenderQueue::submitGeometry(SDL_Renderer* renderer, SDL_Texture* tex) {
+    if (vtx.empty()) return;
+    SDL_RenderGeometry(renderer, tex, vtx.data(), (int)vtx.size(), idx.data(), (int)idx.size());
+    ++drawCalls;
+    vtx.clear(); idx.clear();
+}
+
+// Gửi các lô có layer <= upToLayer (batches đã sắp theo layer)
+void RenderQueue::submitBatches(SDL_Renderer* renderer, size_t& next, int upToLayer) {
+    for (; next < batches.size() && batches[next].layer <= upToLayer; ++next) {
+        const Batch& b = batches[next];
+        SDL_RenderGeometry(renderer, b.tex, b.vtx, b.nv, b.idx, b.ni);
+        ++drawCalls;
+    }
+}
+
+void RenderQueue::flush(SDL_Renderer* renderer) {
+    drawCalls = 0;
+    commands  = (int)(cmds.size() + batches.size());
+    std::stable_sort(batches.begin(), batches.end(), [](const Batch& a, const Batch& b){ return a.layer < b.layer; });
+    size_t nextBatch = 0;
+
+    order.resize(cmds.size());
+    for (uint32_t i = 0; i < (uint32_t)cmds.size(); ++i) order[i] = i;
+    // Layer painter: giữ thứ tự ghi (sprite chồng nhau vẽ trước/sau như scene muốn).
+    // Layer khác: gom theo (kind, khóa texture đăng ký) — không dùng địa chỉ heap nên vẫn tất định.
+    std::sort(order.begin(), order.end(), [&](uint32_t ia, uint32_t ib){
+        const Cmd& a = cmds[ia]; const Cmd& b = cmds[ib];
+        if (a.layer != b.layer) return a.layer < b.layer;
+        if (!painter[a.layer]) {
+            if (a.kind != b.kind)     return a.kind < b.kind;
+            if (a.texKey != b.texKey) return a.texKey < b.texKey;
+        }
+        return a.seq < b.seq;
+    });
+
+    // Gộp các lệnh liền nhau (sau sắp xếp) cùng (layer, kind, tex): geometry gộp đỉnh, line đổi màu khi cần
+    SDL_Texture* curTex = nullptr;
+    int  curLayer = -1, curKind = -1;
+    uint32_t lineColor = 0; bool haveLineColor = false;
+    for (uint32_t oi : order) {
+        const Cmd& c = cmds[oi];
+        bool newGroup = (c.layer != curLayer || c.kind != curKind || c.tex != curTex);
+        if (newGroup) {
+            if (curKind == Geometry) submitGeometry(renderer, curTex);
+            if (c.layer != curLayer) submitBatches(renderer, nextBatch, c.layer - 1);
+            curLayer = c.layer; curKind = c.kind; curTex = c.tex;
+            haveLineColor = false;
+        }
+
+        if (c.kind == Geometry) {
+            int base = (int)vtx.size();
+            for (int v = 0; v < c.verts; ++v) vtx.push_back(SDL_Vertex{ c.p[v], c.color, c.uv[v] });
+            idx.push_back(base); idx.push_back(base + 1); idx.push_back(base + 2);
+            if (c.verts == 4) { idx.push_back(base); idx.push_back(base + 2); idx.push_back(base + 3); }
+        } else {
+            uint32_t col = packColor(c.color);
+            if (!haveLineColor || col != lineColor) {
+                SDL_SetRenderDrawColor(renderer, c.color.r, c.color.g, c.color.b, c.color.a);
+                lineColor = col; haveLineColor = true;
+            }
+            SDL_RenderDrawLine(renderer, (int)c.p[0].x, (int)c.p[0].y, (int)c.p[1].x, (int)c.p[1].y);
+            ++drawCalls;
+        }
+    }
+    if (curKind == Geometry) submitGeometry(renderer, curTex);
+    submitBatches(renderer, nextBatch, 255);
+    clear();
+}
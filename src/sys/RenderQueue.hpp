@@ -0,0 +1,98 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include <bitset>
+#include <unordered_map>
+#include <cstdint>
+
+// Hàng đợi lệnh vẽ của một frame: scene chỉ ghi lệnh (sprite, tam giác, rect, line),
+// không gọi SDL nên có thể dựng ở luồng khác. flush() sắp theo layer, rồi gộp mỗi dãy lệnh liền nhau
+// cùng texture thành 1 lần SDL_RenderGeometry. Trong 1 layer:
+//  - layer painter (mặc định chỉ LayerPlayers, sprite chồng nhau): giữ đúng thứ tự ghi;
+//  - các layer còn lại (nền/tile sân, cột gôn, marker, overlay): sắp theo (loại lệnh, khóa texture)
+//    để ít lần đổi texture nhất; màu đặc (khóa 0) trước texture. Khóa là thứ tự registerTexture,
+//    không phải địa chỉ SDL_Texture* -> thứ tự vẽ như nhau giữa các lần chạy / máy.
+class RenderQueue {
+public:
+    // Thứ tự lớp vẽ (số nhỏ vẽ trước)
+    enum Layer : uint8_t {
+        LayerBackground = 0,
+        LayerPosts      = 1,
+        LayerParticles  = 5,     // vệt bóng, cỏ văng: dưới thực thể
+        LayerBall       = 10,
+        LayerPlayers    = 11,
+        LayerMarkers    = 20,
+        LayerConfetti   = 25,    // pháo giấy: trên thực thể, dưới overlay
+        LayerOverlay    = 30,
+    };
+
+    void clear();
+
+    // Cấp khóa sắp xếp ổn định cho tex (gọi khi nạp/tạo texture; gọi lại không đổi khóa).
+    // Texture chưa đăng ký vẫn vẽ được: xếp sau mọi texture đã đăng ký, giữa chúng theo thứ tự ghi.
+    void registerTexture(SDL_Texture* tex);
+    void unregisterTexture(SDL_Texture* tex);   // trước SDL_DestroyTexture (địa chỉ có thể bị dùng lại)
+
+    // Bật/tắt giữ thứ tự ghi cho một layer (vd. layer mới có sprite chồng nhau)
+    void setPainterOrder(uint8_t layer, bool on) { painter.set(layer, on); }
+
+    void sprite(uint8_t layer, SDL_Texture* tex, const SDL_FRect& dst,
+                SDL_Color tint = SDL_Color{255, 255, 255, 255});
+    // Chỉ vẽ vùng uv (tọa độ chuẩn hóa 0..1) của texture, vd. phần sân trong camera
+    void spriteRegion(uint8_t layer, SDL_Texture* tex, const SDL_FRect& dst, const SDL_FRect& uv,
+                      SDL_Color tint = SDL_Color{255, 255, 255, 255});
+    void triangle(uint8_t layer, SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_Color color);
+    void rect(uint8_t layer, const SDL_FRect& r, SDL_Color color);
+    void line(uint8_t layer, float x1, float y1, float x2, float y2, SDL_Color color);
+    // Lô đỉnh dựng sẵn (vd. particle): gửi nguyên bằng 1 SDL_RenderGeometry, vẽ sau các lệnh cùng layer.
+    // Không copy: vtx/idx thuộc về bên gọi, phải còn sống tới flush()
+    void batch(uint8_t layer, SDL_Texture* tex, const SDL_Vertex* vtx, int nv, const int* idx, int ni);
+
+    // Sắp xếp + gửi toàn bộ lệnh, sau đó clear()
+    void flush(SDL_Renderer* renderer);
+
+    // Thống kê của lần flush gần nhất
+    int lastDrawCalls() const { return drawCalls; }
+    int lastCommands()  const { return commands; }
+
+private:
+    enum Kind : uint8_t { Geometry = 0, Line = 1 };
+
+    struct Cmd {
+        uint8_t      layer;
+        uint8_t      kind;
+        uint8_t      verts;     // 3 (tam giác) hoặc 4 (quad); line dùng 2 điểm đầu
+        uint32_t     seq;       // thứ tự ghi: giữ ổn định khi key bằng nhau
+        uint32_t     texKey;    // 0 = màu đặc, UNREGISTERED = chưa đăng ký
+        SDL_Texture* tex;       // nullptr = màu đặc
+        SDL_FPoint   p[4];
+        SDL_FPoint   uv[4];
+        SDL_Color    color;
+    };
+
+    struct Batch {
+        uint8_t           layer;
+        SDL_Texture*      tex;
+        const SDL_Vertex* vtx;
+        const int*        idx;
+        int               nv, ni;
+    };
+
+    static const uint32_t UNREGISTERED = 0xFFFFFFFFu;
+
+    std::vector<Cmd>      cmds;
+    std::unordered_map<SDL_Texture*, uint32_t> texKeys;
+    uint32_t              nextTexKey = 1;
+    std::bitset<256>      painter{ 1ull << LayerPlayers };   // layer giữ thứ tự ghi
+    std::vector<Batch>    batches;   // giữ thứ tự ghi trong cùng layer
+    std::vector<uint32_t> order;     // chỉ số đã sắp xếp (tránh hoán đổi Cmd lớn)
+    std::vector<SDL_Vertex> vtx;     // bộ đệm đỉnh tái sử dụng giữa các frame
+    std::vector<int>        idx;
+
+    int drawCalls = 0;
+    int commands  = 0;
+
+    void push(const Cmd& c);
+    void submitGeometry(SDL_Renderer* renderer, SDL_Texture* tex);
+    void submitBatches(SDL_Renderer* renderer, size_t& next, int upToLayer);
+};
@@ -0,0 +1,197 @@
+#include "sys/TiledPitch.hpp"
+#include <SDL_image.h>
+#include <algorithm>
+#include <cmath>
+
+bool TiledPitch::open(SDL_Renderer* r, const std::string& path, float fw, float fh, const Params& p) {
+    close();
+    renderer = r; P = p;
+    fieldW = std::max(1.0f, fw); fieldH = std::max(1.0f, fh);
+
+    // tile không vượt giới hạn texture của renderer
+    SDL_RendererInfo info;
+    if (r && SDL_GetRendererInfo(r, &info) == 0 && info.max_texture_width > 0 && info.max_texture_height > 0)
+        P.tilePx = std::min(P.tilePx, std::min(info.max_texture_width, info.max_texture_height));
+    P.tilePx = std::max(16, P.tilePx);
+    // Lũy thừa của 2: tile mip L luôn nằm gọn trong 1 tile của mip tổ tiên (vẽ tạm khi thiếu tile)
+    while (P.tilePx & (P.tilePx - 1)) P.tilePx &= P.tilePx - 1;
+
+    SDL_Surface* img = IMG_Load(path.c_str());
+    if (!img) return false;
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(img, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(img);
+    if (!rgba) return false;
+
+    // Chuỗi mip tới khi cả ảnh gói trong 1 tile
+    const int T = P.tilePx;
+    int w = rgba->w, h = rgba->h;
+    for (;;) {
+        Level L;
+        L.w = w; L.h = h;
+        L.cols = (w + T - 1) / T; L.rows = (h + T - 1) / T;
+        L.slot.assign((size_t)L.cols * L.rows, -1);
+        levels.push_back(std::move(L));
+        if (w <= T && h <= T) break;
+        w = std::max(1, (w + 1) / 2); h = std::max(1, (h + 1) / 2);
+    }
+    levels[0].surf = rgba;
+
+    // Tile mip thô nhất luôn thường trú: chỗ dựa khi tile chi tiết chưa kịp nạp
+    uploadsLeft = 1;
+    int top = (int)levels.size() - 1;
+    int t = acquire(top, 0, 0, true);
+    if (t < 0) { close(); return false; }
+    tiles[t].pinned = true;
+    return true;
+}
+
+void TiledPitch::close() {
+    for (Tile& t : tiles) if (t.tex) SDL_DestroyTexture(t.tex);
+    for (Level& L : levels) if (L.surf) SDL_FreeSurface(L.surf);
+    tiles.clear(); freeTiles.clear(); levels.clear();
+    resident = 0; residentMem = 0;
+}
+
+void TiledPitch::beginFrame() {
+    ++frame;
+    uploadsLeft = P.uploadsPerFrame;
+}
+
+// Mip L từ mip L-1 bằng trung bình 2x2 (cạnh lẻ: lặp lại hàng/cột cuối)
+bool TiledPitch::buildLevel(int level) {
+    if (levels[level].surf) return true;
+    if (level == 0 || !buildLevel(level - 1)) return false;
+    const SDL_Surface* src = levels[level - 1].surf;
+    Level& L = levels[level];
+    SDL_Surface* dst = SDL_CreateRGBSurfaceWithFormat(0, L.w, L.h, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!dst) return false;
+    for (int y = 0; y < L.h; ++y) {
+        const uint8_t* r0 = static_cast<const uint8_t*>(src->pixels) + (size_t)std::min(2 * y,     src->h - 1) * src->pitch;
+        const uint8_t* r1 = static_cast<const uint8_t*>(src->pixels) + (size_t)std::min(2 * y + 1, src->h - 1) * src->pitch;
+        uint8_t* out = static_cast<uint8_t*>(dst->pixels) + (size_t)y * dst->pitch;
+        for (int x = 0; x < L.w; ++x) {
+            int x0 = std::min(2 * x, src->w - 1) * 4, x1 = std::min(2 * x + 1, src->w - 1) * 4;
+            for (int c = 0; c < 4; ++c)
+                out[x * 4 + c] = (uint8_t)((r0[x0 + c] + r0[x1 + c] + r1[x0 + c] + r1[x1 + c] + 2) >> 2);
+        }
+    }
+    L.surf = dst;
+    return true;
+}
+
+void TiledPitch::release(int t) {
+    Tile& tl = tiles[t];
+    SDL_DestroyTexture(tl.tex);
+    levels[tl.level].slot[(size_t)tl.ty * levels[tl.level].cols + tl.tx] = -1;
+    residentMem -= tl.w * tl.h * 4;
+    --resident;
+    tl = Tile{};
+    freeTiles.push_back(t);
+}
+
+// Đẩy tile lâu chưa dùng nhất ra tới khi đủ chỗ; tile đã dùng trong frame này và tile ghim thì giữ
+void TiledPitch::evictUntil(int bytesNeeded) {
+    while (residentMem + bytesNeeded > P.budgetBytes) {
+        int victim = -1;
+        for (int i = 0; i < (int)tiles.size(); ++i) {
+            const Tile& t = tiles[i];
+            if (!t.tex || t.pinned || t.lastUsed == frame) continue;
+            if (victim < 0 || t.lastUsed < tiles[victim].lastUsed) victim = i;
+        }
+        if (victim < 0) return;   // mọi tile đều đang hiện trên màn hình: vượt tạm thời
+        release(victim);
+    }
+}
+
+int TiledPitch::acquire(int level, int tx, int ty, bool mayUpload) {
+    Level& L = levels[level];
+    int& slot = L.slot[(size_t)ty * L.cols + tx];
+    if (slot >= 0) { tiles[slot].lastUsed = frame; return slot; }
+    if (!mayUpload || !buildLevel(level)) return -1;
+
+    const int T = P.tilePx;
+    int w = std::min(T, L.w - tx * T), h = std::min(T, L.h - ty * T);
+    evictUntil(w * h * 4);
+    SDL_Texture* tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, w, h);
+    if (!tex) return -1;
+    // upload thẳng từ vùng của surface mip (pitch của cả ảnh), không copy trung gian
+    const uint8_t* px = static_cast<const uint8_t*>(L.surf->pixels) + (size_t)ty * T * L.surf->pitch + (size_t)tx * T * 4;
+    SDL_UpdateTexture(tex, nullptr, px, L.surf->pitch);
+
+    int t;
+    if (!freeTiles.empty()) { t = freeTiles.back(); freeTiles.pop_back(); }
+    else                    { t = (int)tiles.size(); tiles.emplace_back(); }
+    tiles[t] = Tile{ tex, level, tx, ty, w, h, frame, false };
+    slot = t;
+    ++resident; residentMem += w * h * 4;
+    --uploadsLeft;
+    return t;
+}
+
+// Mip có mật độ texel gần nhất mà vẫn >= mật độ điểm ảnh màn hình
+int TiledPitch::pickLevel(const Camera& cam) const {
+    float tx = ((float)levels[0].w / fieldW) / cam.scaleX();
+    float ty = ((float)levels[0].h / fieldH) / cam.scaleY();
+    float t = std::max(tx, ty);
+    int level = (t > 1.0f) ? (int)std::floor(std::log2(t)) : 0;
+    return std::min(std::max(level, 0), (int)levels.size() - 1);
+}
+
+template <class Fn>
+void TiledPitch::visit(const Camera& cam, bool unlimited, Fn&& fn) {
+    const int T = P.tilePx;
+    const int level = pickLevel(cam);
+    const Level& L = levels[level];
+    const float kx = (float)L.w / fieldW, ky = (float)L.h / fieldH;   // px mip / px sân
+
+    int x0 = std::max(0, (int)std::floor(cam.left() * kx / T));
+    int y0 = std::max(0, (int)std::floor(cam.top() * ky / T));
+    int x1 = std::min(L.cols - 1, (int)std::floor((cam.left() + cam.width()) * kx / T));
+    int y1 = std::min(L.rows - 1, (int)std::floor((cam.top() + cam.height()) * ky / T));
+
+    for (int ty = y0; ty <= y1; ++ty) {
+        for (int tx = x0; tx <= x1; ++tx) {
+            int px0 = tx * T, py0 = ty * T;
+            int pw = std::min(T, L.w - px0), ph = std::min(T, L.h - py0);
+            SDL_FPoint a = cam.toScreen(px0 / kx, py0 / ky);
+            SDL_FPoint b = cam.toScreen((px0 + pw) / kx, (py0 + ph) / ky);
+            SDL_FRect dst{ a.x, a.y, b.x - a.x, b.y - a.y };
+
+            int t = acquire(level, tx, ty, unlimited || uploadsLeft > 0);
+            if (t >= 0) {
+                fn(tiles[t].tex, SDL_FRect{ 0.f, 0.f, (float)pw, (float)ph }, tiles[t].w, tiles[t].h, dst);
+                continue;
+            }
+            // Chưa có: vẽ tạm vùng tương ứng của tổ tiên gần nhất đang thường trú
+            for (int up = level + 1; up < (int)levels.size(); ++up) {
+                int s = up - level;
+                int ax = px0 >> s, ay = py0 >> s;
+                int at = acquire(up, ax / T, ay / T, false);
+                if (at < 0) continue;
+                // kẹp trong tile tổ tiên (mip cạnh lẻ làm tròn lên nên tile mép có thể hụt vài px)
+                const Tile& A = tiles[at];
+                float sxp = (float)(ax % T), syp = (float)(ay % T);
+                float scale = 1.0f / (float)(1 << s);
+                SDL_FRect src{ sxp, syp, std::min(pw * scale, (float)A.w - sxp), std::min(ph * scale, (float)A.h - syp) };
+                if (src.w <= 0.f || src.h <= 0.f) break;
+                fn(A.tex, src, A.w, A.h, dst);
+                break;
+            }
+        }
+    }
+}
+
+void TiledPitch::queue(RenderQueue& q, uint8_t layer, const Camera& cam) {
+    if (!isOpen()) return;
+    visit(cam, false, [&](SDL_Texture* tex, const SDL_FRect& src, int tw, int th, const SDL_FRect& dst) {
+        q.spriteRegion(layer, tex, dst, SDL_FRect{ src.x / tw, src.y / th, src.w / tw, src.h / th });
+    });
+}
+
+void TiledPitch::draw(SDL_Renderer* r, const Camera& cam) {
+    if (!isOpen()) return;
+    visit(cam, true, [&](SDL_Texture* tex, const SDL_FRect& src, int, int, const SDL_FRect& dst) {
+        SDL_Rect s{ (int)src.x, (int)src.y, std::max(1, (int)src.w), std::max(1, (int)src.h) };
+        SDL_RenderCopyF(r, tex, &s, &dst);
+    });
+}
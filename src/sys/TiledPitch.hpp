@@ -0,0 +1,72 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "sys/Camera.hpp"
+#include "sys/RenderQueue.hpp"
+
+// Ảnh sân chia ô (tile) + mip, nạp lên GPU theo nhu cầu quanh vùng camera.
+// Ảnh gốc giải mã 1 lần vào RAM (SDL_image không giải mã được từng vùng); mip L (1/2^L) dựng lười
+// bằng lọc hộp 2x2 khi lần đầu cần. Mỗi tile là 1 texture <= tilePx (không vượt max texture size);
+// tổng texture giữ dưới ngân sách, tile lâu chưa dùng nhất bị giải phóng trước (LRU).
+// Tile thiếu mà hết lượt upload của frame thì vẽ tạm phần tương ứng của tile mip thô hơn;
+// tile mip thô nhất (cả ảnh gói trong 1 tile) luôn thường trú nên không bao giờ có lỗ.
+class TiledPitch {
+public:
+    struct Params {
+        int tilePx = 512;               // cạnh tile (px texture), làm tròn xuống lũy thừa của 2
+        int budgetBytes = 32 << 20;     // ngân sách texture (tile đang vẽ trong frame không bị đẩy ra)
+        int uploadsPerFrame = 4;        // giới hạn upload mỗi frame (tránh giật khi cuộn nhanh)
+    };
+
+    ~TiledPitch() { close(); }
+
+    bool open(SDL_Renderer* renderer, const std::string& path, float fieldW, float fieldH, const Params& p);
+    void close();
+    bool isOpen() const { return !levels.empty(); }
+
+    // Đầu mỗi frame render: tăng đồng hồ LRU, trả lượt upload
+    void beginFrame();
+
+    // Ghi các tile phủ vùng nhìn của camera vào queue (mỗi tile 1 quad)
+    void queue(RenderQueue& q, uint8_t layer, const Camera& cam);
+    // Vẽ trực tiếp (dựng lớp nền tĩnh): không giới hạn upload
+    void draw(SDL_Renderer* renderer, const Camera& cam);
+
+    int residentTiles() const { return resident; }
+    int residentBytes() const { return residentMem; }
+    int levelCount() const { return (int)levels.size(); }
+
+private:
+    struct Level {
+        SDL_Surface* surf = nullptr;    // RGBA32; mip > 0 dựng lười
+        int w = 0, h = 0, cols = 0, rows = 0;
+        std::vector<int> slot;          // chỉ số trong tiles, -1 = chưa nạp
+    };
+    struct Tile {
+        SDL_Texture* tex = nullptr;
+        int level = 0, tx = 0, ty = 0, w = 0, h = 0;
+        uint32_t lastUsed = 0;
+        bool pinned = false;
+    };
+
+    SDL_Renderer* renderer = nullptr;
+    Params P;
+    float fieldW = 1.f, fieldH = 1.f;
+    std::vector<Level> levels;
+    std::vector<Tile>  tiles;
+    std::vector<int>   freeTiles;
+    uint32_t frame = 0;
+    int uploadsLeft = 0;
+    int resident = 0, residentMem = 0;
+
+    int  pickLevel(const Camera& cam) const;
+    bool buildLevel(int level);
+    int  acquire(int level, int tx, int ty, bool mayUpload);
+    void evictUntil(int bytesNeeded);
+    void release(int t);
+
+    // Gọi fn(tex, src px trong texture, kích thước texture, dst màn hình) cho mọi tile phủ vùng nhìn
+    template <class Fn> void visit(const Camera& cam, bool mayUpload, Fn&& fn);
+};
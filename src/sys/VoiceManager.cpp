@@ -0,0 +1,86 @@
+#include "sys/VoiceManager.hpp"
+#include <SDL.h>
+#include <algorithm>
+
+void VoiceManager::init(const Params& p) {
+    close();
+    P = p;
+    P.fieldW = std::max(1.0f, P.fieldW);
+    int want = std::min(std::max(P.voices, 1), MAX_VOICES);
+    voiceCount = std::max(0, std::min(Mix_AllocateChannels(want), want));
+    for (Voice& v : voices) v = Voice{};
+
+    // (ưu tiên, âm lượng, số lần tối đa mỗi 100 ms)
+    auto def = [&](Sound s, uint8_t priority, int volume, int maxPerWindow) {
+        Def& d = defs[s];
+        d.priority = priority; d.volume = volume;
+        d.maxPerWindow = std::min(std::max(maxPerWindow, 1), MAX_RATE);
+        d.window = 0.1f; d.head = 0; d.count = 0;
+    };
+    def(Kick, 2, MIX_MAX_VOLUME,         4);
+    def(Wall, 1, MIX_MAX_VOLUME * 3 / 4, P.wallPerWindow);
+    def(Post, 2, MIX_MAX_VOLUME,         2);
+    def(Goal, 3, MIX_MAX_VOLUME,         1);
+    now = 0.f; droppedCount = 0; stolenCount = 0;
+}
+
+void VoiceManager::close() {
+    if (voiceCount > 0) Mix_HaltChannel(-1);
+    for (Def& d : defs) if (d.chunk) { Mix_FreeChunk(d.chunk); d.chunk = nullptr; }
+    voiceCount = 0;
+}
+
+bool VoiceManager::load(Sound s, const std::string& path) {
+    Def& d = defs[s];
+    if (d.chunk) { Mix_FreeChunk(d.chunk); d.chunk = nullptr; }
+    d.chunk = Mix_LoadWAV(path.c_str());
+    if (!d.chunk) SDL_Log("Audio: cannot load %s\n", path.c_str());
+    return d.chunk != nullptr;
+}
+
+// Còn lượt trong cửa sổ trượt? (lần phát cũ nhất trong vòng đã ra khỏi cửa sổ thì được)
+bool VoiceManager::allow(Def& d) {
+    if (d.count < d.maxPerWindow) return true;
+    int oldest = (d.head - d.maxPerWindow + MAX_RATE) % MAX_RATE;
+    return now - d.recent[oldest] >= d.window;
+}
+
+int VoiceManager::pickVoice(uint8_t priority) {
+    int best = -1;
+    for (int i = 0; i < voiceCount; ++i) {
+        if (!Mix_Playing(i)) { voices[i] = Voice{}; return i; }
+        const Voice& v = voices[i];
+        if (v.priority > priority) continue;
+        if (best < 0) { best = i; continue; }
+        const Voice& b = voices[best];
+        if (v.priority != b.priority) { if (v.priority < b.priority) best = i; continue; }
+        if (v.volume != b.volume)     { if (v.volume < b.volume) best = i; continue; }
+        if (v.started < b.started) best = i;
+    }
+    return best;
+}
+
+int VoiceManager::play(Sound s, float x, float gain) {
+    Def& d = defs[s];
+    if (!d.chunk || voiceCount == 0) return -1;
+    if (!allow(d)) { ++droppedCount; return -1; }
+
+    int ch = pickVoice(d.priority);
+    if (ch < 0) { ++droppedCount; return -1; }
+    // Halt trước (gỡ hiệu ứng pan của tiếng cũ), đặt âm lượng + pan khi kênh đang rảnh rồi mới phát:
+    // buffer đầu tiên đã trộn đúng âm lượng/vị trí, không click hay nhảy pan
+    if (voices[ch].sound >= 0) { Mix_HaltChannel(ch); ++stolenCount; }
+
+    int vol = (int)(d.volume * std::min(std::max(gain, 0.0f), 1.0f) + 0.5f);
+    Mix_Volume(ch, vol);
+    float pan = std::min(std::max(x / P.fieldW, 0.0f), 1.0f);
+    Uint8 right = (Uint8)(pan * 254.0f + 0.5f);
+    Mix_SetPanning(ch, (Uint8)(254 - right), right);
+    if (Mix_PlayChannel(ch, d.chunk, 0) < 0) { voices[ch] = Voice{}; return -1; }
+
+    voices[ch] = Voice{ (int8_t)s, d.priority, vol, now };
+    d.recent[d.head] = now;
+    d.head = (d.head + 1) % MAX_RATE;
+    d.count = std::min(d.count + 1, MAX_RATE);
+    return ch;
+}
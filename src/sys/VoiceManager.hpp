@@ -0,0 +1,71 @@
+#pragma once
+#include <SDL_mixer.h>
+#include <string>
+#include <cstdint>
+
+// Quản lý kênh SFX: pool cố định N kênh (Mix_AllocateChannels) -> mixer không bao giờ trộn quá N tiếng.
+// Mỗi loại âm có độ ưu tiên, âm lượng và giới hạn tần suất (tối đa maxPerWindow lần trong window giây
+// theo đồng hồ trận). Hết kênh trống thì cướp kênh có ưu tiên thấp nhất (<= âm mới), cùng ưu tiên lấy
+// tiếng nhỏ nhất rồi tới cũ nhất; mọi kênh đều quan trọng hơn thì bỏ âm mới.
+// Pan stereo theo x trên sân (Mix_SetPanning). Chunk nạp 1 lần, manager sở hữu.
+class VoiceManager {
+public:
+    enum Sound : uint8_t { Kick = 0, Wall, Post, Goal, SoundCount };
+
+    struct Params {
+        int   voices = 16;          // số kênh SFX (nhạc nền chạy kênh music riêng)
+        int   wallPerWindow = 3;    // tối đa số tiếng chạm tường mỗi 100 ms
+        float fieldW = 1.0f;        // chiều rộng sân: x -> pan
+    };
+
+    VoiceManager() = default;
+    ~VoiceManager() { close(); }
+    VoiceManager(const VoiceManager&) = delete;
+    VoiceManager& operator=(const VoiceManager&) = delete;
+
+    // Cấp phát kênh + đặt bảng âm (giải phóng chunk cũ: gọi load sau init)
+    void init(const Params& p);
+    void close();
+
+    // Nạp chunk cho 1 loại âm (thay chunk cũ nếu có)
+    bool load(Sound s, const std::string& path);
+
+    // Đồng hồ cho giới hạn tần suất (gọi mỗi tick với dt mô phỏng)
+    void update(float dt) { now += dt; }
+
+    // Phát s tại hoành độ x (px sân), gain 0..1 nhân âm lượng gốc; trả kênh hoặc -1 nếu bị bỏ
+    int play(Sound s, float x, float gain = 1.0f);
+
+    int dropped() const { return droppedCount; }   // bị chặn vì tần suất hoặc hết kênh
+    int stolen() const  { return stolenCount; }
+
+private:
+    static constexpr int MAX_VOICES = 64;
+    static constexpr int MAX_RATE   = 16;
+
+    struct Def {
+        Mix_Chunk* chunk = nullptr;
+        uint8_t priority = 0;       // lớn hơn = quan trọng hơn
+        int     volume = MIX_MAX_VOLUME;
+        int     maxPerWindow = MAX_RATE;
+        float   window = 0.1f;
+        float   recent[MAX_RATE] = {};   // vòng thời điểm phát gần nhất
+        int     head = 0, count = 0;
+    };
+    struct Voice {
+        int8_t  sound = -1;
+        uint8_t priority = 0;
+        int     volume = 0;
+        float   started = 0.f;
+    };
+
+    Params P;
+    Def    defs[SoundCount];
+    Voice  voices[MAX_VOICES];
+    int    voiceCount = 0;
+    float  now = 0.f;
+    int    droppedCount = 0, stolenCount = 0;
+
+    bool allow(Def& d);
+    int  pickVoice(uint8_t priority);
+};
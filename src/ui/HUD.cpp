@@ -48,3 +48,13 @@ void HUD::render(const std::string& scoreText,
     // Banner (giữa màn hình)
     renderText(renderer, fontLarge, bannerText, colorWhite, 0, true, true);
 }
+
+void HUD::renderStats(const std::vector<std::string>& lines) {
+    int screenW, screenH;
+    SDL_GetRendererOutputSize(renderer, &screenW, &screenH);
+    int y = screenH / 2 + 60;
+    for (const std::string& line : lines) {
+        renderText(renderer, fontSmall, line, colorWhite, y, true, false);
+        y += 38;
+    }
+}
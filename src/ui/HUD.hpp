@@ -2,6 +2,7 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <string>
+#include <vector>
 
 // Lớp HUD quản lý hiển thị điểm số, thời gian và banner thông báo
 class HUD {
@@ -14,6 +15,9 @@ public:
                 const std::string& timeText,
                 const std::string& bannerText);
 
+    // Bảng thống kê (mỗi dòng 1 chỉ số), canh giữa dưới banner
+    void renderStats(const std::vector<std::string>& lines);
+
 private:
     SDL_Renderer* renderer = nullptr;
     TTF_Font* fontSmall = nullptr;
@@ -0,0 +1,158 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+
+#ifndef TFA_FIXED_POINT
+#define TFA_FIXED_POINT 0
+#endif
+
+// Số thực dấu phẩy tĩnh Q16.16 cho nhánh vật lý tất định (TFA_FIXED_POINT).
+// Mọi phép toán chỉ dùng số nguyên nên kết quả không phụ thuộc libm; float chỉ xuất hiện ở biên
+// (fromFloat/toFloat), vốn là phép chuyển đổi IEEE tất định. Đã đối chiếu từng bit giữa các build
+// gcc (-O0/-O2/-mavx) trên x86-64; MinGW/clang/MSVC chưa được kiểm (chạy tfa_physbench để so băm).
+// Phạm vi ±32768: đủ cho tọa độ sân (px) và vận tốc (px/s); bình phương dùng int64.
+struct Fixed {
+    int32_t raw = 0;
+
+    static constexpr int     FRAC = 16;
+    static constexpr int32_t ONE  = 1 << FRAC;
+
+    static constexpr Fixed fromRaw(int32_t r) { Fixed f; f.raw = r; return f; }
+    static constexpr Fixed fromInt(int v)     { return fromRaw(v * ONE); }
+    static Fixed fromFloat(float v)           { return fromRaw((int32_t)std::lrint(v * (float)ONE)); }
+    float toFloat() const                     { return (float)raw * (1.0f / (float)ONE); }
+
+    constexpr Fixed operator-() const               { return fromRaw(-raw); }
+    constexpr Fixed operator+(Fixed o) const        { return fromRaw(raw + o.raw); }
+    constexpr Fixed operator-(Fixed o) const        { return fromRaw(raw - o.raw); }
+    constexpr Fixed operator*(Fixed o) const {
+        return fromRaw((int32_t)(((int64_t)raw * o.raw + (1 << (FRAC - 1))) >> FRAC));
+    }
+    constexpr Fixed operator/(Fixed o) const {
+        return fromRaw((int32_t)(((int64_t)raw << FRAC) / o.raw));
+    }
+    Fixed& operator+=(Fixed o) { raw += o.raw; return *this; }
+    Fixed& operator-=(Fixed o) { raw -= o.raw; return *this; }
+    Fixed& operator*=(Fixed o) { *this = *this * o; return *this; }
+
+    constexpr bool operator<(Fixed o) const  { return raw <  o.raw; }
+    constexpr bool operator>(Fixed o) const  { return raw >  o.raw; }
+    constexpr bool operator<=(Fixed o) const { return raw <= o.raw; }
+    constexpr bool operator>=(Fixed o) const { return raw >= o.raw; }
+    constexpr bool operator==(Fixed o) const { return raw == o.raw; }
+    constexpr bool operator!=(Fixed o) const { return raw != o.raw; }
+};
+
+struct FxVec2 {
+    Fixed x, y;
+
+    FxVec2() = default;
+    constexpr FxVec2(Fixed x_, Fixed y_) : x(x_), y(y_) {}
+    template <class V> static FxVec2 from(const V& v) { return FxVec2(Fixed::fromFloat(v.x), Fixed::fromFloat(v.y)); }
+    template <class V> V to() const { return V(x.toFloat(), y.toFloat()); }
+
+    FxVec2 operator+(const FxVec2& o) const { return FxVec2(x + o.x, y + o.y); }
+    FxVec2 operator-(const FxVec2& o) const { return FxVec2(x - o.x, y - o.y); }
+    FxVec2 operator*(Fixed s) const         { return FxVec2(x * s, y * s); }
+    FxVec2& operator+=(const FxVec2& o) { x += o.x; y += o.y; return *this; }
+    FxVec2& operator-=(const FxVec2& o) { x -= o.x; y -= o.y; return *this; }
+
+    static Fixed dot(const FxVec2& a, const FxVec2& b) { return a.x * b.x + a.y * b.y; }
+    // |v|^2 ở Q32.32 (không tràn với tọa độ sân)
+    int64_t length2Wide() const { return (int64_t)x.raw * x.raw + (int64_t)y.raw * y.raw; }
+    Fixed length() const;
+};
+
+namespace fx {
+    // Căn bậc hai nguyên (làm tròn xuống): đoán bằng sqrt double (IEEE làm tròn đúng, tất định)
+    // rồi chỉnh ±1 bằng số nguyên nên kết quả luôn là floor(sqrt(v)) chính xác
+    inline uint64_t isqrt64(uint64_t v) {
+        if (v == 0) return 0;
+        uint64_t r = (uint64_t)std::sqrt((double)v);
+        if (r > 0xFFFFFFFFull) r = 0xFFFFFFFFull;
+        while (r * r > v) --r;
+        while ((r + 1) * (r + 1) <= v) ++r;
+        return r;
+    }
+
+    inline Fixed sqrt(Fixed a) {
+        if (a.raw <= 0) return Fixed{};
+        return Fixed::fromRaw((int32_t)isqrt64((uint64_t)a.raw << Fixed::FRAC));
+    }
+
+    inline Fixed min(Fixed a, Fixed b) { return a < b ? a : b; }
+    inline Fixed max(Fixed a, Fixed b) { return a > b ? a : b; }
+
+    // e^x: tách x = k*ln2 + r (|r| <= ln2/2), e^r bằng Taylor bậc 6 rồi dịch k bit
+    inline Fixed exp(Fixed x) {
+        if (x.raw <= -11 * Fixed::ONE) return Fixed{};                    // < 1 raw
+        if (x.raw >=  10 * Fixed::ONE) return Fixed::fromRaw(INT32_MAX);  // bão hòa
+        const int64_t INV_LN2_Q16 = 94548;          // 1/ln2 * 2^16
+        const int64_t LN2_Q32     = 2977044472LL;   // ln2 * 2^32
+        int64_t k = ((int64_t)x.raw * INV_LN2_Q16 + ((int64_t)1 << 31)) >> 32;
+        Fixed r = Fixed::fromRaw(x.raw - (int32_t)((k * LN2_Q32 + (1 << 15)) >> 16));
+        // Horner với 1/n dựng sẵn ở Q16.16 (tránh chia int64)
+        static const int32_t INV_N[7] = { 0, 65536, 32768, 21845, 16384, 13107, 10923 };
+        Fixed p = Fixed::fromInt(1);
+        for (int n = 6; n >= 1; --n) p = Fixed::fromInt(1) + r * p * Fixed::fromRaw(INV_N[n]);
+        int64_t v = p.raw;
+        v = (k >= 0) ? (v << k) : (v >> -k);
+        return Fixed::fromRaw(v > INT32_MAX ? INT32_MAX : (int32_t)v);
+    }
+
+    // sin/cos: đưa về [-pi/2, pi/2] rồi Taylor bậc 9
+    inline Fixed sin(Fixed a) {
+        const int32_t PI_Q16 = 205887, TWO_PI_Q16 = 411775, HALF_PI_Q16 = 102944;
+        int32_t r = a.raw % TWO_PI_Q16;
+        if (r >  PI_Q16) r -= TWO_PI_Q16;
+        if (r < -PI_Q16) r += TWO_PI_Q16;
+        if (r >  HALF_PI_Q16) r =  PI_Q16 - r;
+        if (r < -HALF_PI_Q16) r = -PI_Q16 - r;
+        Fixed x = Fixed::fromRaw(r), x2 = x * x;
+        Fixed p = Fixed::fromInt(1);
+        for (int n = 9; n >= 3; n -= 2) p = Fixed::fromInt(1) - x2 * p / Fixed::fromInt(n * (n - 1));
+        return x * p;
+    }
+    inline Fixed cos(Fixed a) { return sin(a + Fixed::fromRaw(102944)); }
+
+    // ln(a), a > 0: dịch bit đưa a về m in [1/sqrt2, sqrt2) (a = m * 2^e),
+    // ln m = 2*atanh(s) với s = (m-1)/(m+1), |s| <= 0.172 -> chuỗi tới s^7 là đủ Q16.16
+    inline Fixed log(Fixed a) {
+        if (a.raw <= 0) return Fixed::fromRaw(INT32_MIN);
+        const int32_t SQRT2_Q16 = 92682, INV_SQRT2_Q16 = 46341, LN2_Q16 = 45426;
+        int64_t m = a.raw; int e = 0;
+        while (m >= SQRT2_Q16)    { m >>= 1; ++e; }
+        while (m <  INV_SQRT2_Q16) { m <<= 1; --e; }
+        Fixed s  = Fixed::fromRaw((int32_t)m - Fixed::ONE) / Fixed::fromRaw((int32_t)m + Fixed::ONE);
+        Fixed s2 = s * s;
+        Fixed p  = Fixed::fromInt(1) + s2 * (Fixed::fromRaw(21845) + s2 * (Fixed::fromRaw(13107) + s2 * Fixed::fromRaw(9362)));
+        return Fixed::fromRaw(2 * (s * p).raw + e * LN2_Q16);
+    }
+}
+
+inline Fixed FxVec2::length() const { return Fixed::fromRaw((int32_t)fx::isqrt64((uint64_t)length2Wide())); }
+
+// Hàm toán tất định cho code float (input, dắt bóng, gió, quỹ đạo bóng, AI): build TFA_FIXED_POINT
+// đi qua Q16.16, build thường giữ nguyên libm. sqrt của IEEE vốn đã làm tròn đúng nên không cần thay.
+// exp kẹp đầu vào vào [-12, 12] trước khi đổi sang Q16.16 (ngoài khoảng đó fx::exp đã bão hòa;
+// float quá lớn đổi thẳng sẽ tràn lrint, mỗi nền tảng ra một kiểu).
+// log tách mũ bằng frexp (chính xác) nên dùng được cho mọi float dương, không bị giới hạn ±32768.
+#if TFA_FIXED_POINT
+inline float detExp(float x)   { return fx::exp(Fixed::fromFloat(x < -12.0f ? -12.0f : (x > 12.0f ? 12.0f : x))).toFloat(); }
+inline float detExpm1(float x) { return detExp(x) - 1.0f; }
+inline float detLog(float x) {
+    if (!(x > 0.0f)) return -HUGE_VALF;
+    int e; float m = std::frexp(x, &e);      // x = m * 2^e, m in [0.5, 1)
+    return fx::log(Fixed::fromFloat(m)).toFloat() + (float)e * 0.693147181f;
+}
+inline float detLog1p(float x) { return detLog(1.0f + x); }
+inline float detSin(float x) { return fx::sin(Fixed::fromFloat(x)).toFloat(); }
+inline float detCos(float x) { return fx::cos(Fixed::fromFloat(x)).toFloat(); }
+#else
+inline float detExp(float x)   { return std::exp(x); }
+inline float detExpm1(float x) { return std::expm1(x); }
+inline float detLog(float x)   { return std::log(x); }
+inline float detLog1p(float x) { return std::log1p(x); }
+inline float detSin(float x) { return std::sin(x); }
+inline float detCos(float x) { return std::cos(x); }
+#endif
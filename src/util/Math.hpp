@@ -1,5 +1,6 @@
 #pragma once
 #include <cmath>
+#include "util/Fixed.hpp"
 
 // Lớp tiện ích toán học 2D (vector 2 chiều)
 struct Vec2 {
@@ -23,4 +24,26 @@ struct Vec2 {
     static float dot(const Vec2& a, const Vec2& b) {
         return a.x * b.x + a.y * b.y;
     }
+    // Tích có hướng 2D (thành phần z): > 0 nếu b nằm bên trái a
+    static float cross(const Vec2& a, const Vec2& b) {
+        return a.x * b.y - a.y * b.x;
+    }
 };
+
+// Xoay hướng a về phía b, tối đa maxRad radian (dùng chung cho Player/Dribble/Keeper).
+// Công thức cross/dot: so sánh cos góc với cos(maxRad) thay vì acos; vector rỗng coi như (1,0).
+// cosMax/sinMax là cos/sin của maxRad khi gọi nhiều lần với cùng một bước xoay.
+inline Vec2 rotateTowards(const Vec2& a, const Vec2& b, float cosMax, float sinMax) {
+    float la2 = a.length2(), lb2 = b.length2();
+    Vec2 from = (la2 > 1e-12f) ? a * (1.0f / std::sqrt(la2)) : Vec2(1, 0);
+    Vec2 to   = (lb2 > 1e-12f) ? b * (1.0f / std::sqrt(lb2)) : Vec2(1, 0);
+    float c = Vec2::dot(from, to);
+    if (c >= cosMax) return to;   // đã nằm trong bước xoay
+    float sn = (Vec2::cross(from, to) >= 0.f) ? sinMax : -sinMax;
+    return Vec2(from.x*cosMax - from.y*sn, from.x*sn + from.y*cosMax);
+}
+
+inline Vec2 rotateTowards(const Vec2& a, const Vec2& b, float maxRad) {
+    if (maxRad >= 3.14159265f) maxRad = 3.14159265f;   // quá nửa vòng: cos không còn đơn điệu
+    return rotateTowards(a, b, detCos(maxRad), detSin(maxRad));   // tất định khi TFA_FIXED_POINT
+}
@@ -0,0 +1,176 @@
+#include "util/MathBatch.hpp"
+#include <cmath>
+#include <algorithm>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define TFA_VEC_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define TFA_VEC_SSE 1
+#endif
+
+static_assert(sizeof(Vec2) == 2 * sizeof(float), "Vec2 phải là 2 float liền nhau để nạp SIMD");
+
+namespace {
+
+// ---- Scalar (phần dư + fallback) ----
+inline void normalizeOne(Vec2& v) { v = v.normalized(); }
+
+inline void clampOne(Vec2& v, float maxLen) {
+    float l2 = v.length2();
+    if (l2 > maxLen * maxLen) v *= maxLen / std::sqrt(l2);
+}
+
+#if TFA_VEC_SSE
+// Nạp 2 Vec2 (x0,y0,x1,y1) vào một thanh ghi
+inline __m128 load2(const Vec2* p) { return _mm_loadu_ps(&p->x); }
+inline void store2(Vec2* p, __m128 v) { _mm_storeu_ps(&p->x, v); }
+
+// (x0,y0,x1,y1) -> (l0,l0,l1,l1) với l = x*x + y*y
+inline __m128 len2Pairs(__m128 v) {
+    __m128 sq = _mm_mul_ps(v, v);
+    __m128 sw = _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_add_ps(sq, sw);
+}
+
+// (x0,y0,x1,y1) -> (-y0,x0,-y1,x1): xoay 90 độ từng cặp
+inline __m128 perpPairs(__m128 v) {
+    const __m128 signLo = _mm_castsi128_ps(_mm_set_epi32(0, (int)0x80000000, 0, (int)0x80000000));
+    __m128 sw = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_xor_ps(sw, signLo);
+}
+
+// Chuẩn hóa từng cặp; độ dài^2 <= eps2 -> fallback
+inline __m128 normalizePairs(__m128 v, __m128 fallback, float eps2) {
+    __m128 l2   = len2Pairs(v);
+    __m128 zero = _mm_cmple_ps(l2, _mm_set1_ps(eps2));
+    __m128 n    = _mm_div_ps(v, _mm_sqrt_ps(_mm_max_ps(l2, _mm_set1_ps(1e-30f))));
+    return _mm_or_ps(_mm_and_ps(zero, fallback), _mm_andnot_ps(zero, n));
+}
+#endif
+
+#if TFA_VEC_AVX
+inline __m256 len2Pairs8(__m256 v) {
+    __m256 sq = _mm256_mul_ps(v, v);
+    return _mm256_add_ps(sq, _mm256_permute_ps(sq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+#endif
+
+} // namespace
+
+namespace VecBatch {
+
+void normalize(Vec2* v, int n) {
+    int i = 0;
+#if TFA_VEC_AVX
+    for (; i + 4 <= n; i += 4) {
+        __m256 a    = _mm256_loadu_ps(&v[i].x);
+        __m256 l2   = len2Pairs8(a);
+        __m256 zero = _mm256_cmp_ps(l2, _mm256_setzero_ps(), _CMP_EQ_OQ);
+        __m256 r    = _mm256_div_ps(a, _mm256_sqrt_ps(_mm256_max_ps(l2, _mm256_set1_ps(1e-30f))));
+        _mm256_storeu_ps(&v[i].x, _mm256_andnot_ps(zero, r));
+    }
+#endif
+#if TFA_VEC_SSE
+    for (; i + 2 <= n; i += 2) store2(&v[i], normalizePairs(load2(&v[i]), _mm_setzero_ps(), 0.0f));
+#endif
+    for (; i < n; ++i) normalizeOne(v[i]);
+}
+
+void rotateTowards(Vec2* dir, const Vec2* target, int n, float maxRad) {
+    if (maxRad >= 3.14159265f) maxRad = 3.14159265f;
+    const float cosMax = detCos(maxRad), sinMax = detSin(maxRad);   // như ::rotateTowards
+    int i = 0;
+#if TFA_VEC_SSE
+    const __m128 unitX = _mm_set_ps(0.f, 1.f, 0.f, 1.f);
+    const __m128 vCos  = _mm_set1_ps(cosMax);
+    const __m128 vSin  = _mm_set1_ps(sinMax);
+    const __m128 sign  = _mm_set1_ps(-0.0f);
+    for (; i + 2 <= n; i += 2) {
+        __m128 from = normalizePairs(load2(&dir[i]),    unitX, 1e-12f);
+        __m128 to   = normalizePairs(load2(&target[i]), unitX, 1e-12f);
+
+        // dot = fx*tx + fy*ty ; cross = fx*ty - fy*tx  (nhân bản cho cả 2 làn x,y)
+        __m128 prod  = _mm_mul_ps(from, to);
+        __m128 dot   = _mm_add_ps(prod, _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(2, 3, 0, 1)));
+        __m128 cprod = _mm_mul_ps(perpPairs(from), to);    // (-fy*tx, fx*ty, ...)
+        __m128 cross = _mm_add_ps(cprod, _mm_shuffle_ps(cprod, cprod, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        // sn = ±sinMax theo dấu cross (cross >= 0 -> dương, giống bản scalar)
+        __m128 neg = _mm_cmplt_ps(cross, _mm_setzero_ps());
+        __m128 sn  = _mm_xor_ps(vSin, _mm_and_ps(neg, sign));
+
+        // rot = from*cos + perp(from)*sn
+        __m128 rot  = _mm_add_ps(_mm_mul_ps(from, vCos), _mm_mul_ps(perpPairs(from), sn));
+        __m128 done = _mm_cmpge_ps(dot, vCos);
+        store2(&dir[i], _mm_or_ps(_mm_and_ps(done, to), _mm_andnot_ps(done, rot)));
+    }
+#endif
+    for (; i < n; ++i) dir[i] = ::rotateTowards(dir[i], target[i], cosMax, sinMax);
+}
+
+void damp(Vec2* v, int n, float k, float dt) {
+    const float f = std::exp(-k * dt);
+    int i = 0;
+#if TFA_VEC_AVX
+    const __m256 f8 = _mm256_set1_ps(f);
+    for (; i + 4 <= n; i += 4) _mm256_storeu_ps(&v[i].x, _mm256_mul_ps(_mm256_loadu_ps(&v[i].x), f8));
+#endif
+#if TFA_VEC_SSE
+    const __m128 f4 = _mm_set1_ps(f);
+    for (; i + 2 <= n; i += 2) store2(&v[i], _mm_mul_ps(load2(&v[i]), f4));
+#endif
+    for (; i < n; ++i) v[i] *= f;
+}
+
+void damp(Vec2* v, const float* k, int n, float dt) {
+    int i = 0;
+#if TFA_VEC_SSE
+    for (; i + 2 <= n; i += 2) {
+        float f0 = std::exp(-k[i] * dt), f1 = std::exp(-k[i + 1] * dt);
+        store2(&v[i], _mm_mul_ps(load2(&v[i]), _mm_set_ps(f1, f1, f0, f0)));
+    }
+#endif
+    for (; i < n; ++i) v[i] *= std::exp(-k[i] * dt);
+}
+
+void clampLength(Vec2* v, int n, float maxLen) {
+    int i = 0;
+#if TFA_VEC_AVX
+    const __m256 max8  = _mm256_set1_ps(maxLen);
+    const __m256 max28 = _mm256_set1_ps(maxLen * maxLen);
+    for (; i + 4 <= n; i += 4) {
+        __m256 a    = _mm256_loadu_ps(&v[i].x);
+        __m256 l2   = len2Pairs8(a);
+        __m256 over = _mm256_cmp_ps(l2, max28, _CMP_GT_OQ);
+        __m256 s    = _mm256_div_ps(max8, _mm256_sqrt_ps(_mm256_max_ps(l2, max28)));
+        _mm256_storeu_ps(&v[i].x, _mm256_blendv_ps(a, _mm256_mul_ps(a, s), over));
+    }
+#endif
+#if TFA_VEC_SSE
+    const __m128 max4  = _mm_set1_ps(maxLen);
+    const __m128 max24 = _mm_set1_ps(maxLen * maxLen);
+    for (; i + 2 <= n; i += 2) {
+        __m128 a    = load2(&v[i]);
+        __m128 l2   = len2Pairs(a);
+        __m128 over = _mm_cmpgt_ps(l2, max24);
+        __m128 s    = _mm_div_ps(max4, _mm_sqrt_ps(_mm_max_ps(l2, max24)));
+        store2(&v[i], _mm_or_ps(_mm_and_ps(over, _mm_mul_ps(a, s)), _mm_andnot_ps(over, a)));
+    }
+#endif
+    for (; i < n; ++i) clampOne(v[i], maxLen);
+}
+
+const char* backendName() {
+#if TFA_VEC_AVX
+    return "avx";
+#elif TFA_VEC_SSE
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace VecBatch
@@ -0,0 +1,26 @@
+#pragma once
+#include "util/Math.hpp"
+
+// Các kernel toán 2D chạy theo lô (mảng Vec2 liên tiếp).
+// Có nhánh SSE (mặc định trên x86-64) và AVX (khi build với TFA_ENABLE_AVX);
+// phần dư cuối mảng luôn chạy scalar. normalize/damp/clampLength khớp từng bit với bản Vec2 thường,
+// rotateTowards lệch tối đa cỡ 1e-7 (tfa_physbench in sai số và ns/phần tử của từng kernel).
+// Đang dùng: damp trong vòng tích hợp của PhysicsSystem::stepFloat.
+namespace VecBatch {
+    // v[i] = v[i].normalized()  (vector rỗng giữ nguyên (0,0))
+    void normalize(Vec2* v, int n);
+
+    // dir[i] = rotateTowards(dir[i], target[i], maxRad) — cùng một bước xoay cho cả lô
+    void rotateTowards(Vec2* dir, const Vec2* target, int n, float maxRad);
+
+    // v[i] *= exp(-k*dt)  (một hệ số cản chung)
+    void damp(Vec2* v, int n, float k, float dt);
+    // v[i] *= exp(-k[i]*dt)  (hệ số cản riêng từng phần tử)
+    void damp(Vec2* v, const float* k, int n, float dt);
+
+    // Kẹp độ dài: |v[i]| <= maxLen
+    void clampLength(Vec2* v, int n, float maxLen);
+
+    // Tên nhánh SIMD đang được biên dịch ("avx", "sse2" hoặc "scalar")
+    const char* backendName();
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+
+// PCG32 (O'Neill): nhỏ, nhanh, trạng thái 16 byte, không dùng biến toàn cục.
+// Mỗi stream (increment lẻ khác nhau) cho một chuỗi số độc lập với cùng seed.
+class Pcg32 {
+public:
+    Pcg32() { seed(0x853c49e6748fea9bULL, 0xda3e39cb94b95bdbULL); }
+    Pcg32(uint64_t seedValue, uint64_t stream) { seed(seedValue, stream); }
+
+    void seed(uint64_t seedValue, uint64_t stream) {
+        state = 0u;
+        inc = (stream << 1u) | 1u;
+        nextU32();
+        state += seedValue;
+        nextU32();
+    }
+
+    uint32_t nextU32() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = (uint32_t)(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    // [0, 1) — dùng 24 bit cao để khớp độ chính xác của float
+    float nextFloat() { return (nextU32() >> 8) * (1.0f / 16777216.0f); }
+
+    // [a, b)
+    float range(float a, float b) { return a + (b - a) * nextFloat(); }
+
+    uint64_t rawState() const { return state; }   // cho băm trạng thái
+    uint64_t rawInc() const { return inc; }
+    // Khôi phục nguyên trạng (checkpoint), không chạy lại seed
+    void setRaw(uint64_t s, uint64_t i) { state = s; inc = i | 1u; }
+
+private:
+    uint64_t state;
+    uint64_t inc;
+};
+
+// Bộ sinh số ngẫu nhiên của một trận: mỗi loại ngẫu nhiên có stream riêng,
+// nên thêm/bớt lần rút ở stream này không làm lệch các stream khác.
+class MatchRng {
+public:
+    enum Stream { WindDir = 0, WindGust, AiNoise, WindField, StreamCount };
+
+    void seed(uint64_t s) {
+        seedValue = s;
+        for (int i = 0; i < StreamCount; ++i) streams[i].seed(s, 0x5446410000000000ULL + (uint64_t)i);
+    }
+    uint64_t getSeed() const { return seedValue; }
+
+    Pcg32& operator[](Stream s) { return streams[s]; }
+    float range(Stream s, float a, float b) { return streams[s].range(a, b); }
+    uint64_t streamState(Stream s) const { return streams[s].rawState(); }
+    uint64_t streamInc(Stream s) const { return streams[s].rawInc(); }
+
+    // Khôi phục seed + trạng thái mọi stream (checkpoint)
+    void restore(uint64_t s, const uint64_t* state, const uint64_t* inc) {
+        seedValue = s;
+        for (int i = 0; i < StreamCount; ++i) streams[i].setRaw(state[i], inc[i]);
+    }
+
+private:
+    uint64_t seedValue = 0;
+    Pcg32 streams[StreamCount];
+};
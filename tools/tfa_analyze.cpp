@@ -0,0 +1,370 @@
+// tfa_analyze: phân tích offline một thư mục telemetry (.tfat / .tfaq) song song trên nhiều core.
+// Mỗi luồng giữ bộ cộng dồn riêng, đọc từng file theo dòng (không giữ cả trận trong RAM),
+// cuối cùng gộp lại và xuất CSV + PNG.
+//
+//   tfa_analyze <dir> [-o out] [-j threads] [--grid 60x35] [--shot-speed 12]
+//
+// Không phụ thuộc SDL: chỉ dùng TelemetryReader / TelemetryCodec.
+#include "core/Telemetry.hpp"
+#include "core/TelemetryReader.hpp"
+#include "core/TelemetryCodec.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* BODY_NAMES[Telemetry::BODY_COUNT] = { "ball", "p1", "p2", "gk1", "gk2" };
+const uint8_t STATE_PLAYING = 1;     // MatchState::Playing
+const float   GOAL_BIN_SEC  = 10.f;  // độ rộng cột histogram thời điểm ghi bàn
+const int     GOAL_BINS     = 64;
+
+struct Options {
+    std::string dir;
+    std::string out = "analysis";
+    unsigned threads = 0;
+    int gridW = 60, gridH = 35;
+    float shotSpeedMps = 12.f;        // tốc độ bóng tối thiểu để tính là sút (m/s)
+};
+
+struct Shot {
+    uint64_t seed;
+    uint32_t tick;
+    float time;
+    int   kicker;
+    float x, y;      // tọa độ chuẩn hóa [0,1]
+    float speed;     // px/s
+};
+
+// Bộ cộng dồn của một luồng
+struct Accum {
+    std::vector<uint64_t> heat[Telemetry::BODY_COUNT];   // số tick mỗi ô lưới
+    std::vector<uint64_t> shotHeat;
+    double possession[Telemetry::BODY_COUNT + 1] = {};   // [0] = bóng tự do, [i] = body i
+    uint64_t goalBins[GOAL_BINS] = {};
+    std::vector<Shot> shots;
+    uint64_t matches = 0, failed = 0, records = 0, goals = 0;
+
+    void init(int cells) {
+        for (auto& h : heat) h.assign(cells, 0);
+        shotHeat.assign(cells, 0);
+    }
+    void merge(const Accum& o) {
+        for (int b = 0; b < Telemetry::BODY_COUNT; ++b)
+            for (size_t i = 0; i < heat[b].size(); ++i) heat[b][i] += o.heat[b][i];
+        for (size_t i = 0; i < shotHeat.size(); ++i) shotHeat[i] += o.shotHeat[i];
+        for (int i = 0; i <= Telemetry::BODY_COUNT; ++i) possession[i] += o.possession[i];
+        for (int i = 0; i < GOAL_BINS; ++i) goalBins[i] += o.goalBins[i];
+        shots.insert(shots.end(), o.shots.begin(), o.shots.end());
+        matches += o.matches; failed += o.failed; records += o.records; goals += o.goals;
+    }
+};
+
+// Phân tích tuần tự các record của một trận
+class MatchAnalyzer {
+public:
+    MatchAnalyzer(const Options& o, const Telemetry::Header& h, Accum& a)
+        : opt(o), hdr(h), acc(a),
+          sx(o.gridW / std::max(1.f, h.fieldW)), sy(o.gridH / std::max(1.f, h.fieldH)),
+          shotSpeed(o.shotSpeedMps * 40.f) {}   // PPM = 40
+
+    void operator()(const Telemetry::Record& r) {
+        ++acc.records;
+        float dt = first ? 0.f : std::max(0.f, r.simTime - prev.simTime);
+
+        if (r.state == STATE_PLAYING) {
+            for (int b = 0; b < Telemetry::BODY_COUNT; ++b)
+                ++acc.heat[b][cell(r.bodies[b].px, r.bodies[b].py)];
+            int owner = (r.ownerId >= 1 && r.ownerId < Telemetry::BODY_COUNT) ? r.ownerId : 0;
+            acc.possession[owner] += dt;
+        }
+
+        // đầu hiệp: ghi lại đồng hồ để tính thời điểm bàn thắng trong hiệp
+        if (first || r.half != prev.half) halfStartClock = r.timeRemaining;
+
+        if (!first) {
+            detectShot(r);
+            int goalsNow = r.scoreLeft + r.scoreRight, goalsPrev = prev.scoreLeft + prev.scoreRight;
+            if (goalsNow > goalsPrev) {
+                acc.goals += goalsNow - goalsPrev;
+                float elapsed = std::max(0.f, halfStartClock - r.timeRemaining);
+                int bin = std::min(GOAL_BINS - 1, (int)(elapsed / GOAL_BIN_SEC));
+                acc.goalBins[bin] += goalsNow - goalsPrev;
+            }
+        }
+        prev = r; first = false;
+    }
+
+private:
+    int cell(float px, float py) const {
+        int cx = std::min(opt.gridW - 1, std::max(0, (int)(px * sx)));
+        int cy = std::min(opt.gridH - 1, std::max(0, (int)(py * sy)));
+        return cy * opt.gridW + cx;
+    }
+
+    // Cú sút: lastKickerId đổi sang người mới, hoặc người đang giữ bóng đá bóng đi (owner -> -1)
+    void detectShot(const Telemetry::Record& r) {
+        bool newKicker = r.lastKickerId >= 0 && r.lastKickerId != prev.lastKickerId;
+        bool released  = prev.ownerId >= 0 && r.ownerId < 0 && r.lastKickerId == prev.ownerId;
+        if (!newKicker && !released) return;
+        const Telemetry::Body& b = r.bodies[0];
+        float speed = std::sqrt(b.vx * b.vx + b.vy * b.vy);
+        if (speed < shotSpeed) return;
+        // vị trí sút = chỗ bóng ở tick trước (lúc còn trong chân)
+        const Telemetry::Body& at = prev.bodies[0];
+        Shot s{ hdr.seed, r.tick, r.simTime, r.lastKickerId,
+                at.px / std::max(1.f, hdr.fieldW), at.py / std::max(1.f, hdr.fieldH), speed };
+        acc.shots.push_back(s);
+        ++acc.shotHeat[cell(at.px, at.py)];
+    }
+
+    const Options& opt;
+    const Telemetry::Header& hdr;
+    Accum& acc;
+    float sx, sy, shotSpeed;
+    Telemetry::Record prev{};
+    bool first = true;
+    float halfStartClock = 0.f;
+};
+
+bool endsWith(const std::string& s, const char* suf) {
+    size_t n = std::strlen(suf);
+    return s.size() >= n && s.compare(s.size() - n, n, suf) == 0;
+}
+
+bool analyzeFile(const std::string& path, const Options& opt, Accum& acc, std::vector<uint8_t>& buf) {
+    if (endsWith(path, ".tfat")) {
+        TelemetryReader in;
+        if (!in.open(path)) return false;
+        MatchAnalyzer an(opt, in.header(), acc);
+        in.forEach(an);
+        return true;
+    }
+    // .tfaq: đọc nguyên file (đã nén nên nhỏ) vào buffer dùng lại của luồng rồi giải mã tiến
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::fseek(f, 0, SEEK_END);
+    long sz = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    buf.resize(sz > 0 ? (size_t)sz : 0);
+    bool ok = sz > 0 && std::fread(buf.data(), 1, buf.size(), f) == buf.size();
+    std::fclose(f);
+    if (!ok) return false;
+
+    TelemetryCodec::Decoder dec;
+    if (!dec.open(buf.data(), buf.size())) return false;
+    Telemetry::Header h = dec.header().source;
+    MatchAnalyzer an(opt, h, acc);
+    dec.forEach(an);
+    return true;
+}
+
+// ===== PNG tối giản: deflate "stored" (không nén) + CRC32/Adler32 =====
+uint32_t crc32(const uint8_t* p, size_t n, uint32_t c = 0) {
+    static uint32_t table[256];
+    static bool ready = false;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t v = i;
+            for (int k = 0; k < 8; ++k) v = (v & 1) ? 0xEDB88320u ^ (v >> 1) : v >> 1;
+            table[i] = v;
+        }
+        ready = true;
+    }
+    c = ~c;
+    for (size_t i = 0; i < n; ++i) c = table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return ~c;
+}
+
+void put32(std::vector<uint8_t>& v, uint32_t x) {
+    v.push_back(x >> 24); v.push_back(x >> 16); v.push_back(x >> 8); v.push_back(x);
+}
+
+void pngChunk(FILE* f, const char* type, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> c;
+    put32(c, (uint32_t)data.size());
+    c.insert(c.end(), type, type + 4);
+    c.insert(c.end(), data.begin(), data.end());
+    put32(c, crc32(c.data() + 4, c.size() - 4));
+    std::fwrite(c.data(), 1, c.size(), f);
+}
+
+bool writePng(const std::string& path, int w, int h, const std::vector<uint8_t>& rgb) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    static const uint8_t sig[8] = { 137, 'P', 'N', 'G', 13, 10, 26, 10 };
+    std::fwrite(sig, 1, 8, f);
+
+    std::vector<uint8_t> ihdr;
+    put32(ihdr, w); put32(ihdr, h);
+    ihdr.push_back(8); ihdr.push_back(2); ihdr.push_back(0); ihdr.push_back(0); ihdr.push_back(0);
+    pngChunk(f, "IHDR", ihdr);
+
+    // dòng quét: byte filter 0 + RGB
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)h * (w * 3 + 1));
+    for (int y = 0; y < h; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgb.begin() + (size_t)y * w * 3, rgb.begin() + (size_t)(y + 1) * w * 3);
+    }
+    std::vector<uint8_t> z = { 0x78, 0x01 };
+    uint32_t a = 1, b = 0;
+    for (uint8_t x : raw) { a = (a + x) % 65521; b = (b + a) % 65521; }
+    for (size_t off = 0; off < raw.size() || off == 0; ) {
+        size_t n = std::min<size_t>(65535, raw.size() - off);
+        bool last = off + n >= raw.size();
+        z.push_back(last ? 1 : 0);
+        z.push_back(n & 0xFF); z.push_back(n >> 8);
+        z.push_back(~n & 0xFF); z.push_back((~n >> 8) & 0xFF);
+        z.insert(z.end(), raw.begin() + off, raw.begin() + off + n);
+        off += n;
+        if (last) break;
+    }
+    put32(z, (b << 16) | a);
+    pngChunk(f, "IDAT", z);
+    pngChunk(f, "IEND", {});
+    return std::fclose(f) == 0;
+}
+
+// Bảng màu nhiệt đen -> đỏ -> vàng -> trắng, thang căn bậc 2 để vùng ít cũng thấy được
+void heatColor(float t, uint8_t* out) {
+    t = std::sqrt(std::min(1.f, std::max(0.f, t)));
+    float r = std::min(1.f, t * 3.f), g = std::min(1.f, std::max(0.f, t * 3.f - 1.f)), b = std::max(0.f, t * 3.f - 2.f);
+    out[0] = (uint8_t)(r * 255); out[1] = (uint8_t)(g * 255); out[2] = (uint8_t)(b * 255);
+}
+
+void writeHeatmap(const std::string& base, const std::vector<uint64_t>& h, int gw, int gh) {
+    uint64_t total = 0, mx = 1;
+    for (uint64_t v : h) { total += v; mx = std::max(mx, v); }
+
+    FILE* f = std::fopen((base + ".csv").c_str(), "w");
+    if (f) {
+        for (int y = 0; y < gh; ++y) {
+            for (int x = 0; x < gw; ++x)
+                std::fprintf(f, x ? ",%.6f" : "%.6f", total ? (double)h[y * gw + x] / total : 0.0);
+            std::fputc('\n', f);
+        }
+        std::fclose(f);
+    }
+
+    const int scale = 8;   // phóng to mỗi ô để ảnh dễ xem
+    int w = gw * scale, hh = gh * scale;
+    std::vector<uint8_t> rgb((size_t)w * hh * 3);
+    for (int y = 0; y < hh; ++y)
+        for (int x = 0; x < w; ++x)
+            heatColor((float)h[(y / scale) * gw + x / scale] / mx, &rgb[((size_t)y * w + x) * 3]);
+    writePng(base + ".png", w, hh, rgb);
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        if (a == "-o") { const char* v = next(); if (!v) return false; o.out = v; }
+        else if (a == "-j") { const char* v = next(); if (!v) return false; o.threads = (unsigned)std::atoi(v); }
+        else if (a == "--grid") {
+            const char* v = next();
+            if (!v || std::sscanf(v, "%dx%d", &o.gridW, &o.gridH) != 2 || o.gridW <= 0 || o.gridH <= 0) return false;
+        }
+        else if (a == "--shot-speed") { const char* v = next(); if (!v) return false; o.shotSpeedMps = (float)std::atof(v); }
+        else if (o.dir.empty() && a[0] != '-') o.dir = a;
+        else return false;
+    }
+    return !o.dir.empty();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::fprintf(stderr, "usage: tfa_analyze <dir> [-o out] [-j threads] [--grid WxH] [--shot-speed m/s]\n");
+        return 2;
+    }
+
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(opt.dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file()) continue;
+        std::string p = it->path().string();
+        if (endsWith(p, ".tfat") || endsWith(p, ".tfaq")) files.push_back(p);
+    }
+    if (files.empty()) { std::fprintf(stderr, "tfa_analyze: no telemetry files in %s\n", opt.dir.c_str()); return 1; }
+
+    unsigned n = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    n = std::min<unsigned>(n, (unsigned)files.size());
+    const int cells = opt.gridW * opt.gridH;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<Accum> accs(n);
+    for (auto& a : accs) a.init(cells);
+    std::atomic<size_t> nextFile{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < n; ++t) {
+        pool.emplace_back([&, t]() {
+            std::vector<uint8_t> buf;
+            Accum& acc = accs[t];
+            for (size_t i; (i = nextFile.fetch_add(1, std::memory_order_relaxed)) < files.size(); ) {
+                if (analyzeFile(files[i], opt, acc, buf)) ++acc.matches;
+                else ++acc.failed;
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+
+    Accum total;
+    total.init(cells);
+    for (const auto& a : accs) total.merge(a);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    fs::create_directories(opt.out, ec);
+    const std::string out = opt.out + "/";
+
+    for (int b = 0; b < Telemetry::BODY_COUNT; ++b)
+        writeHeatmap(out + "heatmap_" + BODY_NAMES[b], total.heat[b], opt.gridW, opt.gridH);
+    writeHeatmap(out + "shotmap", total.shotHeat, opt.gridW, opt.gridH);
+
+    if (FILE* f = std::fopen((out + "possession.csv").c_str(), "w")) {
+        double all = 0;
+        for (double v : total.possession) all += v;
+        std::fprintf(f, "owner,seconds,share\n");
+        std::fprintf(f, "free,%.3f,%.4f\n", total.possession[0], all > 0 ? total.possession[0] / all : 0.0);
+        for (int b = 1; b < Telemetry::BODY_COUNT; ++b)
+            std::fprintf(f, "%s,%.3f,%.4f\n", BODY_NAMES[b], total.possession[b], all > 0 ? total.possession[b] / all : 0.0);
+        std::fclose(f);
+    }
+
+    if (FILE* f = std::fopen((out + "shots.csv").c_str(), "w")) {
+        std::fprintf(f, "seed,tick,time,kicker,x,y,speed_mps\n");
+        for (const Shot& s : total.shots)
+            std::fprintf(f, "%llu,%u,%.3f,%s,%.4f,%.4f,%.2f\n", (unsigned long long)s.seed, s.tick, s.time,
+                         (s.kicker > 0 && s.kicker < Telemetry::BODY_COUNT) ? BODY_NAMES[s.kicker] : "?",
+                         s.x, s.y, s.speed / 40.f);
+        std::fclose(f);
+    }
+
+    if (FILE* f = std::fopen((out + "goal_times.csv").c_str(), "w")) {
+        std::fprintf(f, "from_s,to_s,goals\n");
+        for (int i = 0; i < GOAL_BINS; ++i)
+            if (total.goalBins[i])
+                std::fprintf(f, "%.0f,%.0f,%llu\n", i * GOAL_BIN_SEC, (i + 1) * GOAL_BIN_SEC, (unsigned long long)total.goalBins[i]);
+        std::fclose(f);
+    }
+
+    std::printf("tfa_analyze: %llu matches (%llu failed), %llu ticks, %zu shots, %llu goals in %.2fs on %u threads -> %s\n",
+                (unsigned long long)total.matches, (unsigned long long)total.failed,
+                (unsigned long long)total.records, total.shots.size(), (unsigned long long)total.goals,
+                secs, n, opt.out.c_str());
+    return total.matches ? 0 : 1;
+}
@@ -0,0 +1,238 @@
+// tfa_physbench: đo thông lượng PhysicsSystem (float vs Q16.16) trên một đám đông dựng sẵn
+// và in băm trạng thái cuối. Chạy cùng lệnh trên các máy/compiler khác nhau: băm của nhánh
+// fixed phải trùng từng bit (nhánh float thì không bảo đảm).
+//
+//   tfa_physbench [ticks=20000] [players=20] [substeps=2] [iterations=6] [crowd=4096]
+//
+//   crowd: số Player trong mảng đo applyInput (vd. 262144 để vượt hẳn cache)
+//
+// Kịch bản tất định: cầu thủ chạy về các mục tiêu xoay vòng quanh tâm sân, bóng bị sút định kỳ.
+// Kèm bố cục bộ nhớ của Player (phần nóng nằm trong mấy cache line), thông lượng applyInput
+// trên một mảng Player liền nhau, và VecBatch so với bản Vec2 scalar: sai số lớn nhất (abs, ULP)
+// rồi ns/phần tử của từng kernel.
+#include "ecs/Ball.hpp"
+#include "ecs/Goal.hpp"
+#include "ecs/Player.hpp"
+#include "sys/Physics.hpp"
+#include "util/MathBatch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+const int   FIELD_W = 1280, FIELD_H = 720;
+const float DT = 1.0f / 120.0f;
+
+struct Result { double ticksPerSec; uint64_t hash; };
+
+uint64_t fnv1a(uint64_t h, const void* p, size_t n) {
+    const unsigned char* b = static_cast<const unsigned char*>(p);
+    for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 1099511628211ULL; }
+    return h;
+}
+
+Result run(bool fixedPoint, int ticks, int players, int substeps, int iterations) {
+    Goals goals; goals.init(FIELD_W, FIELD_H, 120.0f, 8.0f);
+    Ball ball;
+    ball.id = 0; ball.radius = 12.0f; ball.mass = 0.43f; ball.drag = 0.8f; ball.e_wall = 0.5f;
+    ball.tf.pos = Vec2(FIELD_W * 0.5f, FIELD_H * 0.5f);
+
+    std::vector<std::unique_ptr<Player>> ps;
+    std::vector<Entity*> ents{ &ball };
+    for (int i = 0; i < players; ++i) {
+        ps.emplace_back(new Player());
+        Player& p = *ps.back();
+        p.id = i + 1; p.radius = 30.0f; p.mass = 70.0f; p.drag = 2.0f; p.e_wall = 0.05f;
+        p.vmax = 6.0f * 40.0f; p.accel = 25.0f * 40.0f;
+        p.tf.pos = Vec2(200.0f + (i % 8) * 110.0f, 150.0f + (i / 8) * 140.0f);
+        ents.push_back(&p);
+    }
+
+    PhysicsSystem::Params prm;
+    prm.substeps = substeps; prm.iterations = iterations; prm.fixedPoint = fixedPoint;
+    PhysicsSystem phys(prm);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        // mục tiêu đổi mỗi 2 giây; chỉ dùng + - * / và sqrt (IEEE, tất định)
+        int phase = (t / 240) % 4;
+        for (int i = 0; i < players; ++i) {
+            Player& p = *ps[i];
+            int k = (i + phase) % 4;
+            Vec2 target(FIELD_W * (0.35f + 0.1f * k), FIELD_H * (0.35f + 0.1f * ((k + 1) % 4)));
+            Vec2 d = target - p.tf.pos;
+            float len = d.length();
+            if (len > 1.0f) p.tf.vel += d * (p.accel * DT / len);
+            float sp = p.tf.vel.length();
+            if (sp > p.vmax) p.tf.vel = p.tf.vel * (p.vmax / sp);
+        }
+        if (t % 180 == 0) ball.tf.vel = Vec2((t % 360) ? 700.0f : -650.0f, (t % 540) ? 300.0f : -420.0f);
+        phys.step(DT, ents, goals, FIELD_W, FIELD_H);
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    uint64_t h = 1469598103934665603ULL;
+    for (Entity* e : ents) {
+        h = fnv1a(h, &e->tf.pos, sizeof(Vec2));
+        h = fnv1a(h, &e->tf.vel, sizeof(Vec2));
+    }
+    return { sec > 0 ? ticks / sec : 0.0, h };
+}
+
+// Trường nóng = từ đầu object tới isGoalkeeper (vptr, Entity, input, cooldown, cờ)
+void printLayout() {
+    Player p;
+    auto off = [&](const void* f) { return (size_t)((const char*)f - (const char*)&p); };
+    size_t hotEnd = off(&p.isGoalkeeper) + sizeof(p.isGoalkeeper);
+    std::printf("Player: sizeof %zu (%zu cache lines), hot [0, %zu) = %zu line(s), drb @%zu, visual @%zu\n",
+                sizeof(Player), (sizeof(Player) + 63) / 64, hotEnd, (hotEnd + 63) / 64,
+                off(&p.drb), off(&p.visual));
+}
+
+// applyInput + tích hợp vị trí trên mảng liền nhau: bước nhảy giữa 2 cầu thủ = sizeof(Player)
+double benchApplyInput(int ticks, int players) {
+    std::vector<Player> ps(players);
+    for (int i = 0; i < players; ++i) {
+        Player& p = ps[i];
+        p.drag = 2.0f; p.vmax = 6.0f * 40.0f; p.accel = 25.0f * 40.0f;
+        p.tf.pos = Vec2((float)(i % FIELD_W), (float)(i % FIELD_H));
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        for (int i = 0; i < players; ++i) {
+            Player& p = ps[i];
+            p.in.x = (float)((t / 50 + i) % 3 - 1); p.in.y = (float)((t / 70 + i) % 3 - 1);
+            p.applyInput(DT);
+            p.tf.pos += p.tf.vel * DT;
+        }
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return sec * 1e9 / ((double)ticks * players);
+}
+
+// ---- VecBatch vs Vec2 scalar ----
+const int   VB_N = 4099;            // lẻ: phần dư scalar cũng được đo
+const float VB_TURN = 0.05f, VB_MAXLEN = 240.0f;
+
+std::vector<Vec2> vbVectors(uint32_t seed, float scale) {
+    std::vector<Vec2> v(VB_N);
+    for (Vec2& a : v) {
+        seed = seed * 1664525u + 1013904223u; a.x = ((seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f) * scale;
+        seed = seed * 1664525u + 1013904223u; a.y = ((seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f) * scale;
+    }
+    v[0] = Vec2(0.0f, 0.0f);        // vector rỗng
+    return v;
+}
+
+// Khoảng cách ULP giữa 2 float (cùng thứ tự với số thực)
+int64_t ulpDiff(float a, float b) {
+    int32_t ia, ib;
+    std::memcpy(&ia, &a, 4); std::memcpy(&ib, &b, 4);
+    if (ia < 0) ia = INT32_MIN - ia;
+    if (ib < 0) ib = INT32_MIN - ib;
+    return ia > ib ? (int64_t)ia - ib : (int64_t)ib - ia;
+}
+
+void vbCompare(const char* name, const std::vector<Vec2>& ref, const std::vector<Vec2>& got) {
+    float maxAbs = 0.0f; int64_t maxUlp = 0;
+    for (int i = 0; i < VB_N; ++i) {
+        maxAbs = std::max({ maxAbs, std::fabs(ref[i].x - got[i].x), std::fabs(ref[i].y - got[i].y) });
+        maxUlp = std::max({ maxUlp, ulpDiff(ref[i].x, got[i].x), ulpDiff(ref[i].y, got[i].y) });
+    }
+    std::printf("  %-13s max abs %.3g  max ulp %lld\n", name, maxAbs, (long long)maxUlp);
+}
+
+// ns/phần tử của f(v, lần lặp) chạy reps lần trên mảng VB_N phần tử (nằm gọn trong L1/L2)
+template <class F>
+double vbTime(std::vector<Vec2> v, int reps, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) f(v.data(), r);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    volatile float sink = v[VB_N / 2].x + v[VB_N - 1].y;   // giữ kết quả sống
+    (void)sink;
+    return sec * 1e9 / ((double)reps * VB_N);
+}
+
+void benchVecBatch(int reps) {
+    const std::vector<Vec2> vel = vbVectors(1u, 400.0f), tA = vbVectors(2u, 1.0f), tB = vbVectors(3u, 1.0f);
+    std::vector<float> k(VB_N);
+    for (int i = 0; i < VB_N; ++i) k[i] = (i % 3) ? 0.0f : 0.8f;   // như integrate: chỉ bóng có cản
+    std::vector<Vec2> ref, got;
+
+    std::printf("VecBatch (%s), %d vectors:\n", VecBatch::backendName(), VB_N);
+    ref = got = vel;
+    for (Vec2& a : ref) a = a.normalized();
+    VecBatch::normalize(got.data(), VB_N);
+    vbCompare("normalize", ref, got);
+
+    ref = got = vel;
+    for (int i = 0; i < VB_N; ++i) ref[i] = rotateTowards(ref[i], tA[i], VB_TURN);
+    VecBatch::rotateTowards(got.data(), tA.data(), VB_N, VB_TURN);
+    vbCompare("rotateTowards", ref, got);
+
+    ref = got = vel;
+    for (int i = 0; i < VB_N; ++i) ref[i] *= std::exp(-k[i] * DT);
+    VecBatch::damp(got.data(), k.data(), VB_N, DT);
+    vbCompare("damp", ref, got);
+
+    ref = got = vel;
+    for (Vec2& a : ref) { float l2 = a.length2(); if (l2 > VB_MAXLEN * VB_MAXLEN) a *= VB_MAXLEN / std::sqrt(l2); }
+    VecBatch::clampLength(got.data(), VB_N, VB_MAXLEN);
+    vbCompare("clampLength", ref, got);
+
+    // target / maxLen đổi mỗi lượt: hướng luôn còn phải xoay, luôn có vector bị kẹp
+    auto turnScalar = [&](Vec2* v, int r) {
+        const Vec2* t = (r & 1) ? tB.data() : tA.data();
+        for (int i = 0; i < VB_N; ++i) v[i] = rotateTowards(v[i], t[i], VB_TURN);
+    };
+    auto turnBatch = [&](Vec2* v, int r) { VecBatch::rotateTowards(v, (r & 1) ? tB.data() : tA.data(), VB_N, VB_TURN); };
+    auto dampScalar = [&](Vec2* v, int) { for (int i = 0; i < VB_N; ++i) v[i] *= std::exp(-k[i] * DT); };
+    auto dampBatch  = [&](Vec2* v, int) { VecBatch::damp(v, k.data(), VB_N, DT); };
+    auto clampScalar = [&](Vec2* v, int r) {
+        float m = (r & 1) ? VB_MAXLEN : VB_MAXLEN * 0.5f;
+        for (int i = 0; i < VB_N; ++i) { float l2 = v[i].length2(); if (l2 > m * m) v[i] *= m / std::sqrt(l2); }
+    };
+    auto clampBatch = [&](Vec2* v, int r) { VecBatch::clampLength(v, VB_N, (r & 1) ? VB_MAXLEN : VB_MAXLEN * 0.5f); };
+    auto normScalar = [&](Vec2* v, int) { for (int i = 0; i < VB_N; ++i) v[i] = v[i].normalized(); };
+    auto normBatch  = [&](Vec2* v, int) { VecBatch::normalize(v, VB_N); };
+
+    struct Row { const char* name; double scalar, batch; } rows[] = {
+        { "normalize",     vbTime(vel, reps, normScalar),  vbTime(vel, reps, normBatch)  },
+        { "rotateTowards", vbTime(vel, reps, turnScalar),  vbTime(vel, reps, turnBatch)  },
+        { "damp",          vbTime(vel, reps, dampScalar),  vbTime(vel, reps, dampBatch)  },
+        { "clampLength",   vbTime(vel, reps, clampScalar), vbTime(vel, reps, clampBatch) },
+    };
+    for (const Row& r : rows)
+        std::printf("  %-13s scalar %6.2f ns  batch %6.2f ns  x%.2f\n", r.name, r.scalar, r.batch,
+                    r.batch > 0 ? r.scalar / r.batch : 0.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int ticks      = (argc > 1) ? std::atoi(argv[1]) : 20000;
+    int players    = (argc > 2) ? std::atoi(argv[2]) : 20;
+    int substeps   = (argc > 3) ? std::atoi(argv[3]) : 2;
+    int iterations = (argc > 4) ? std::atoi(argv[4]) : 6;
+    int crowd      = (argc > 5) ? std::max(1, std::atoi(argv[5])) : 4096;
+
+    std::printf("ticks=%d players=%d substeps=%d iterations=%d (build TFA_FIXED_POINT=%d)\n",
+                ticks, players, substeps, iterations, TFA_FIXED_POINT);
+    Result f = run(false, ticks, players, substeps, iterations);
+    Result q = run(true,  ticks, players, substeps, iterations);
+    std::printf("float  : %10.0f ticks/s  hash %016llx\n", f.ticksPerSec, (unsigned long long)f.hash);
+    std::printf("fixed  : %10.0f ticks/s  hash %016llx\n", q.ticksPerSec, (unsigned long long)q.hash);
+    std::printf("fixed/float throughput: %.2f\n", f.ticksPerSec > 0 ? q.ticksPerSec / f.ticksPerSec : 0.0);
+    printLayout();
+    std::printf("applyInput: %.2f ns/player (%d players)\n", benchApplyInput(std::max(1, ticks / 10), crowd), crowd);
+    benchVecBatch(std::max(1, ticks / 20));
+    return 0;
+}